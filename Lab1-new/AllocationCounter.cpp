@@ -0,0 +1,28 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+using namespace std;
+
+#ifdef COUNT_HEAP_ALLOCATIONS
+
+static atomic<size_t> heapAllocations(0);
+
+void* operator new(size_t size) {
+    heapAllocations.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+bool heapAllocationsCounted() { return true; }
+size_t heapAllocationCount() { return heapAllocations.load(memory_order_relaxed); }
+
+#else
+
+bool heapAllocationsCounted() { return false; }
+size_t heapAllocationCount() { return 0; }
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+// Heap allocation count for the benchmarks. The counting operator new is
+// compiled in only with COUNT_HEAP_ALLOCATIONS defined, so regular builds
+// keep the standard allocator; without it the count stays 0.
+bool heapAllocationsCounted();
+size_t heapAllocationCount();
+
+#endif // ALLOCATION_COUNTER_H
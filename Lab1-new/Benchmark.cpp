@@ -0,0 +1,1046 @@
+#include "Benchmark.h"
+#include "SocialNetwork.h"
+#include "Logger.h"
+#include "Parallel.h"
+#include "SetIntersection.h"
+#include "Simd.h"
+#include "Communities.h"
+#include "NeighborhoodFunction.h"
+#include "AllocationCounter.h"
+#include <chrono>
+#include <random>
+#include <set>
+#include <map>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <queue>
+#include <cmath>
+#include <memory>
+#include <cstdlib>
+using namespace std;
+
+using BenchClock = chrono::steady_clock;
+
+static double elapsedMs(BenchClock::time_point start) {
+    return chrono::duration<double, milli>(BenchClock::now() - start).count();
+}
+
+static void printRow(const string& label, double ms, const string& extra = "") {
+    cout << "  " << left << setw(40) << label << right << setw(12)
+        << fixed << setprecision(3) << ms << " ms";
+    if (!extra.empty()) cout << "   " << extra;
+    cout << endl;
+}
+
+static void buildRandomFriendships(SocialNetwork& net, int userCount, int friendshipCount, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> pick(0, userCount - 1);
+    for (int i = 0; i < userCount; ++i)
+        net.addVertex(new User(i, "User" + to_string(i), "user" + to_string(i) + "@mail.com"));
+    for (int i = 0; i < friendshipCount; ++i) {
+        int a = pick(rng), b = pick(rng);
+        if (a != b) net.addEdge(new Friendship(a, b));
+    }
+}
+
+void benchmarkFriendOfFriend(int userCount, int friendshipCount, int queries) {
+    cout << "\n[friend-of-friend] users=" << userCount << " edges=" << friendshipCount
+        << " queries=" << queries << endl;
+
+    SocialNetwork net;
+    auto start = BenchClock::now();
+    buildRandomFriendships(net, userCount, friendshipCount, 42);
+    printRow("build", elapsedMs(start));
+
+    mt19937 rng(7);
+    uniform_int_distribution<int> pick(0, userCount - 1);
+    vector<int> sources(queries);
+    for (auto& s : sources) s = pick(rng);
+
+    // Before: neighbor lookup as a scan over the whole edge list.
+    auto allEdges = net.getAllEdges();
+    auto scanNeighbors = [&allEdges](int id) {
+        vector<int> result;
+        for (auto* e : allEdges)
+            if (e->getFrom() == id) result.push_back(e->getTo());
+        return result;
+        };
+
+    size_t reachedScan = 0;
+    start = BenchClock::now();
+    for (int s : sources) {
+        set<int> twoHop;
+        for (int f : scanNeighbors(s))
+            for (int ff : scanNeighbors(f))
+                if (ff != s) twoHop.insert(ff);
+        reachedScan += twoHop.size();
+    }
+    double scanMs = elapsedMs(start);
+    printRow("edge scan (before)", scanMs / queries, "per query");
+
+    // After: per-vertex adjacency index.
+    size_t reachedIndex = 0;
+    start = BenchClock::now();
+    for (int s : sources) {
+        set<int> twoHop;
+        for (int f : net.getNeighbors(s))
+            for (int ff : net.getNeighbors(f))
+                if (ff != s) twoHop.insert(ff);
+        reachedIndex += twoHop.size();
+    }
+    double indexMs = elapsedMs(start);
+    printRow("adjacency index (after)", indexMs / queries, "per query");
+
+    cout << "  speedup x" << setprecision(1) << (indexMs > 0 ? scanMs / indexMs : 0.0)
+        << (reachedScan == reachedIndex ? "" : "  [RESULT MISMATCH]") << endl;
+}
+
+// Same workload as SocialNetwork::generateRandomUsers, but every user and
+// relationship is a separate heap object, as before the slab pools.
+static void generateHeapUsers(SocialNetwork& network, int n) {
+    for (int i = 0; i < n; ++i) {
+        string name = "User" + to_string(i + 1);
+        network.addVertex(new User(i, name, name + "@mail.com"));
+    }
+    for (int i = 0; i < n * 1.5; ++i) {
+        int u1 = rand() % n, u2 = rand() % n, u3 = rand() % n;
+        int u4 = rand() % n, u5 = rand() % n, u6 = rand() % n;
+        if (u1 != u2) network.addEdge(new Friendship(u1, u2));
+        if (u3 != u4) network.addEdge(new Subscription(u3, u4));
+        network.addEdge(new Post(rand() % n, "post"));
+        if (u5 != u6) network.addEdge(new Message(u5, u6, "message"));
+    }
+}
+
+void benchmarkAllocation(int userCount) {
+    cout << "\n[allocation] users=" << userCount << " (generateRandomUsers workload)" << endl;
+    if (!heapAllocationsCounted())
+        cout << "  allocation counts need a build with COUNT_HEAP_ALLOCATIONS defined" << endl;
+
+    auto run = [userCount](const string& label, bool pooled) {
+        auto net = unique_ptr<SocialNetwork>(new SocialNetwork());
+        size_t allocationsBefore = heapAllocationCount();
+        auto start = BenchClock::now();
+        if (pooled) SocialNetwork::generateRandomUsers(*net, userCount, true);
+        else {
+            srand(12345);
+            generateHeapUsers(*net, userCount);
+        }
+        double buildMs = elapsedMs(start);
+        size_t allocations = heapAllocationCount() - allocationsBefore;
+        size_t objects = net->getAllVertices().size() + net->edgeCount();
+
+        start = BenchClock::now();
+        net.reset();
+        double teardownMs = elapsedMs(start);
+
+        printRow(label + " construct", buildMs, to_string(allocations) + " allocations for " + to_string(objects) + " objects");
+        printRow(label + " destroy", teardownMs);
+        };
+
+    run("heap (before)", false);
+    run("slab pools (after)", true);
+}
+
+void benchmarkSearchResults(int userCount, int friendshipCount, int queries) {
+    cout << "\n[search results] users=" << userCount << " edges=" << friendshipCount
+        << " queries=" << queries << endl;
+    if (!heapAllocationsCounted())
+        cout << "  allocation counts need a build with COUNT_HEAP_ALLOCATIONS defined" << endl;
+
+    SocialNetwork net;
+    buildRandomFriendships(net, userCount, friendshipCount, 42);
+
+    mt19937 rng(11);
+    uniform_int_distribution<int> pick(0, userCount - 1);
+    vector<int> sources(queries);
+    for (auto& s : sources) s = pick(rng);
+    net.breadthFirstSearch(sources[0], Layer::Friendship);
+
+    auto run = [&](const string& label, bool asMap) {
+        size_t reached = 0;
+        size_t allocationsBefore = heapAllocationCount();
+        auto start = BenchClock::now();
+        for (int s : sources) {
+            auto view = net.breadthFirstSearch(s, Layer::Friendship);
+            if (asMap) {
+                map<int, int> dist = view.toMap();
+                reached += dist.size();
+            }
+            else {
+                reached += view.size();
+            }
+        }
+        double ms = elapsedMs(start);
+        size_t allocations = heapAllocationCount() - allocationsBefore;
+        printRow(label, ms / queries, "per query, " + to_string(allocations / queries) +
+            " allocations per query, reached " + to_string(reached / queries));
+        return ms;
+        };
+
+    // Before: every query materialized a map<int,int> of distances.
+    double mapMs = run("map<int,int> (before)", true);
+    // After: the view reads the reused dense buffers in place.
+    double viewMs = run("dense view (after)", false);
+    cout << "  speedup x" << setprecision(1) << (viewMs > 0 ? mapMs / viewMs : 0.0) << endl;
+}
+
+void benchmarkParallelBfs(int vertexCount, int edgeCount, int queries) {
+    cout << "\n[parallel bfs] vertices=" << vertexCount << " edges=" << edgeCount
+        << " queries=" << queries << " hardware threads=" << hardwareThreads() << endl;
+
+    mt19937 rng(3);
+    uniform_int_distribution<int> pick(0, vertexCount - 1);
+    vector<pair<int, int>> edges(edgeCount);
+    for (auto& e : edges) e = { pick(rng), pick(rng) };
+    CsrGraph g = CsrGraph::fromEdges(edges);
+    vector<int> sources(queries);
+    for (auto& s : sources) s = g.idOf(pick(rng) % g.vertexCount());
+
+    // Before: single-threaded top-down queue BFS.
+    vector<int> dist(g.vertexCount());
+    vector<int> queue;
+    queue.reserve(g.vertexCount());
+    size_t reachedSequential = 0;
+    auto start = BenchClock::now();
+    for (int s : sources) {
+        fill(dist.begin(), dist.end(), -1);
+        queue.assign(1, g.indexOf(s));
+        dist[queue[0]] = 0;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int u = queue[head];
+            for (int v : g.neighbors(u)) {
+                if (dist[v] < 0) {
+                    dist[v] = dist[u] + 1;
+                    queue.push_back(v);
+                }
+            }
+        }
+        reachedSequential += queue.size();
+    }
+    double sequentialMs = elapsedMs(start);
+    printRow("top-down queue (before)", sequentialMs / queries, "per query");
+
+    // After: direction-optimizing bitmap BFS at 1..N threads.
+    SearchWorkspace ws;
+    GraphAlgorithms::breadthFirstSearch(g, sources[0], ws, 1);
+    for (int threads = 1; ; threads = min(threads * 2, hardwareThreads())) {
+        size_t reached = 0;
+        start = BenchClock::now();
+        for (int s : sources)
+            reached += GraphAlgorithms::breadthFirstSearch(g, s, ws, threads).size();
+        double ms = elapsedMs(start);
+        ostringstream extra;
+        extra << "per query, x" << fixed << setprecision(1) << (ms > 0 ? sequentialMs / ms : 0.0)
+            << (reached == reachedSequential ? "" : "  [RESULT MISMATCH]");
+        printRow("direction-optimizing, " + to_string(threads) + " thr", ms / queries, extra.str());
+        if (threads >= hardwareThreads()) break;
+    }
+}
+
+void benchmarkPointToPoint(int userCount, int friendshipCount, int queries) {
+    cout << "\n[point-to-point] users=" << userCount << " edges=" << friendshipCount
+        << " queries=" << queries << endl;
+
+    SocialNetwork net;
+    buildRandomFriendships(net, userCount, friendshipCount, 42);
+    net.setThreadCount(1);
+
+    mt19937 rng(5);
+    uniform_int_distribution<int> pick(0, userCount - 1);
+    vector<pair<int, int>> pairs(queries);
+    for (auto& p : pairs) p = { pick(rng), pick(rng) };
+
+    // Before: full single-source BFS, then a lookup of the target.
+    long long totalFull = 0;
+    auto start = BenchClock::now();
+    for (auto& p : pairs) {
+        auto dist = net.breadthFirstSearch(p.first, Layer::Friendship);
+        totalFull += dist.count(p.second) ? dist.at(p.second) : -1;
+    }
+    double fullMs = elapsedMs(start);
+    printRow("full BFS (before)", fullMs / queries, "per query");
+
+    // After: bidirectional search that stops where the frontiers meet.
+    long long totalBidirectional = 0;
+    start = BenchClock::now();
+    for (auto& p : pairs)
+        totalBidirectional += net.pathLength(p.first, p.second, Layer::Friendship);
+    double bidirectionalMs = elapsedMs(start);
+    printRow("bidirectional (after)", bidirectionalMs / queries, "per query");
+
+    cout << "  speedup x" << setprecision(1) << (bidirectionalMs > 0 ? fullMs / bidirectionalMs : 0.0)
+        << (totalFull == totalBidirectional ? "" : "  [RESULT MISMATCH]") << endl;
+}
+
+void benchmarkConnectivity(int userCount, int friendshipCount, int queries) {
+    cout << "\n[connectivity] users=" << userCount << " edges=" << friendshipCount
+        << " queries=" << queries << endl;
+
+    // Sparse enough to leave many components.
+    SocialNetwork net;
+    buildRandomFriendships(net, userCount, friendshipCount, 42);
+
+    mt19937 rng(9);
+    uniform_int_distribution<int> pick(0, userCount - 1);
+    vector<pair<int, int>> pairs(queries);
+    for (auto& p : pairs) p = { pick(rng), pick(rng) };
+
+    auto run = [&](const string& label, bool unionFind) {
+        size_t connected = 0;
+        auto start = BenchClock::now();
+        for (auto& p : pairs)
+            connected += unionFind ? net.inSameComponent(p.first, p.second, Layer::Friendship)
+            : net.hasPath(p.first, p.second, Layer::Friendship);
+        double ms = elapsedMs(start);
+        printRow(label, ms, "for all queries, " + to_string(connected) + " connected");
+        return ms;
+        };
+
+    // Before: a search per pair.
+    double searchMs = run("bidirectional search (before)", false);
+    // After: union-find maintained on insertion.
+    double unionFindMs = run("union-find (after)", true);
+
+    // One removal per round: the first query after it rebuilds the component.
+    auto start = BenchClock::now();
+    for (int i = 0; i < 100; ++i) {
+        auto friends = net.getNeighbors(pairs[i].first);
+        if (!friends.empty()) net.removeFriendship(pairs[i].first, friends[0]);
+        net.inSameComponent(pairs[i].first, pairs[i].second, Layer::Friendship);
+    }
+    printRow("removal + lazy rebuild", elapsedMs(start) / 100, "per round");
+
+    cout << "  speedup x" << setprecision(1) << (unionFindMs > 0 ? searchMs / unionFindMs : 0.0) << endl;
+}
+
+void benchmarkDeltaStepping(int userCount, int friendshipCount, int queries) {
+    cout << "\n[delta-stepping] users=" << userCount << " friendships=" << friendshipCount
+        << " queries=" << queries << " hardware threads=" << hardwareThreads() << endl;
+
+    // shortestPathsFrom's own input: the tie graph, with a subscription for
+    // every fourth friendship so tie strengths (and weights) vary.
+    SocialNetwork net;
+    buildRandomFriendships(net, userCount, friendshipCount, 21);
+    mt19937 rng(22);
+    uniform_int_distribution<int> pick(0, userCount - 1);
+    for (int i = 0; i < friendshipCount / 4; ++i) {
+        int a = pick(rng), b = pick(rng);
+        if (a != b) net.addEdge(new Subscription(a, b));
+    }
+    auto start = BenchClock::now();
+    const CsrGraph& g = net.tieGraph();
+    printRow("build tie graph", elapsedMs(start), to_string(g.edgeCount()) + " weighted edges");
+    vector<int> sources(queries);
+    for (auto& s : sources) s = g.idOf(pick(rng) % g.vertexCount());
+
+    // Default: binary-heap Dijkstra, as shortestPathsFrom runs it.
+    SearchWorkspace ws;
+    double checksumDijkstra = 0;
+    start = BenchClock::now();
+    for (int s : sources)
+        for (auto entry : GraphAlgorithms::weightedDijkstra(g, s, ws))
+            checksumDijkstra += entry.second;
+    double dijkstraMs = elapsedMs(start);
+    printRow("binary-heap Dijkstra (default)", dijkstraMs / queries, "per query");
+
+    // Experimental: delta-stepping at 1..N threads.
+    GraphAlgorithms::deltaStepping(g, sources[0], ws, 0, 1);
+    for (int threads = 1; ; threads = min(threads * 2, hardwareThreads())) {
+        double checksum = 0;
+        start = BenchClock::now();
+        for (int s : sources)
+            for (auto entry : GraphAlgorithms::deltaStepping(g, s, ws, 0, threads))
+                checksum += entry.second;
+        double ms = elapsedMs(start);
+        ostringstream extra;
+        extra << "per query, x" << fixed << setprecision(2) << (ms > 0 ? dijkstraMs / ms : 0.0)
+            << (abs(checksum - checksumDijkstra) <= 1e-6 * checksumDijkstra ? "" : "  [RESULT MISMATCH]");
+        printRow("delta-stepping, " + to_string(threads) + " thr", ms / queries, extra.str());
+        if (threads >= hardwareThreads()) break;
+    }
+}
+
+void benchmarkMultiSourceBfs(int vertexCount, int edgeCount, int sourceCount) {
+    cout << "\n[multi-source bfs] vertices=" << vertexCount << " edges=" << edgeCount
+        << " sources=" << sourceCount << " hardware threads=" << hardwareThreads() << endl;
+
+    mt19937 rng(17);
+    uniform_int_distribution<int> pick(0, vertexCount - 1);
+    vector<pair<int, int>> edges(edgeCount);
+    for (auto& e : edges) e = { pick(rng), pick(rng) };
+    CsrGraph g = CsrGraph::fromEdges(edges);
+    vector<int> sources(sourceCount);
+    for (auto& s : sources) s = g.idOf(pick(rng) % g.vertexCount());
+
+    // Before: one direction-optimizing BFS per source.
+    SearchWorkspace ws;
+    long long totalSingle = 0;
+    auto start = BenchClock::now();
+    for (int s : sources)
+        for (auto entry : GraphAlgorithms::breadthFirstSearch(g, s, ws))
+            totalSingle += entry.second;
+    double singleMs = elapsedMs(start);
+    printRow("BFS per source (before)", singleMs, "for all sources");
+
+    // After: 64 sources per shared traversal.
+    long long totalBatch = 0;
+    start = BenchClock::now();
+    auto batch = GraphAlgorithms::multiSourceBfs(g, sources, ws);
+    for (size_t i = 0; i < batch.sourceCount(); ++i)
+        for (int d : batch.row(i))
+            if (d > 0) totalBatch += d;
+    double batchMs = elapsedMs(start);
+    printRow("multi-source BFS (after)", batchMs, "for all sources");
+
+    cout << "  speedup x" << setprecision(1) << (batchMs > 0 ? singleMs / batchMs : 0.0)
+        << (totalSingle == totalBatch ? "" : "  [RESULT MISMATCH]") << endl;
+}
+
+void benchmarkDistanceOracle(int userCount, int friendshipCount, int queries) {
+    cout << "\n[distance oracle] users=" << userCount << " edges=" << friendshipCount
+        << " queries=" << queries << endl;
+
+    SocialNetwork net;
+    buildRandomFriendships(net, userCount, friendshipCount, 42);
+    net.setThreadCount(1);
+
+    mt19937 rng(11);
+    uniform_int_distribution<int> pick(0, userCount - 1);
+    vector<pair<int, int>> pairs(queries);
+    for (auto& p : pairs) p = { pick(rng), pick(rng) };
+
+    // Before: a bidirectional search per pair.
+    vector<int> truth(queries);
+    auto start = BenchClock::now();
+    for (int i = 0; i < queries; ++i)
+        truth[i] = net.pathLength(pairs[i].first, pairs[i].second, Layer::Friendship);
+    double searchMs = elapsedMs(start);
+    printRow("bidirectional search (before)", searchMs / queries, "per query");
+
+    for (int landmarks : { 4, 16, 64 }) {
+        start = BenchClock::now();
+        net.enableDistanceOracle(landmarks, Layer::Friendship);
+        net.waitForDistanceOracle();
+        printRow("oracle build, k=" + to_string(landmarks), elapsedMs(start));
+
+        size_t exact = 0, wrong = 0;
+        long long slack = 0;
+        start = BenchClock::now();
+        for (int i = 0; i < queries; ++i) {
+            auto estimate = net.estimateDistance(pairs[i].first, pairs[i].second);
+            if (estimate.exact) {
+                ++exact;
+                wrong += estimate.upper != truth[i];
+            }
+            else if (estimate.upper >= 0) {
+                slack += estimate.upper - estimate.lower;
+            }
+        }
+        double ms = elapsedMs(start);
+        ostringstream extra;
+        extra << "per query, " << exact * 100 / queries << "% exact, mean gap "
+            << fixed << setprecision(2) << (queries > static_cast<int>(exact) ? double(slack) / (queries - exact) : 0.0)
+            << (wrong ? "  [RESULT MISMATCH]" : "");
+        printRow("oracle estimate, k=" + to_string(landmarks), ms / queries, extra.str());
+    }
+}
+
+void benchmarkTriangles(int vertexCount, int edgeCount) {
+    cout << "\n[triangles] vertices=" << vertexCount << " edges=" << edgeCount
+        << " hardware threads=" << hardwareThreads() << endl;
+
+    // Endpoints drawn as n * x^3 give a few hubs and a long tail.
+    mt19937 rng(23);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    auto skewed = [&]() { double x = unit(rng); return static_cast<int>(vertexCount * x * x * x); };
+    vector<pair<int, int>> edges(edgeCount);
+    for (auto& e : edges) e = { skewed(), skewed() };
+    CsrGraph g = CsrGraph::fromEdges(edges);
+    int maxDegree = 0;
+    for (int v = 0; v < g.vertexCount(); ++v) maxDegree = max(maxDegree, g.degree(v));
+    cout << "  max degree " << maxDegree << endl;
+
+    // Before: index-ordered merge of full neighbor rows, listing every triangle.
+    long long before = 0;
+    auto start = BenchClock::now();
+    for (int u = 0; u < g.vertexCount(); ++u) {
+        auto nu = g.neighbors(u);
+        for (int v : nu) {
+            if (v <= u) continue;
+            auto nv = g.neighbors(v);
+            const int* a = upper_bound(nu.begin(), nu.end(), v);
+            const int* b = upper_bound(nv.begin(), nv.end(), v);
+            while (a != nu.end() && b != nv.end()) {
+                if (*a < *b) ++a;
+                else if (*b < *a) ++b;
+                else { ++before; ++a; ++b; }
+            }
+        }
+    }
+    double beforeMs = elapsedMs(start);
+    printRow("index-ordered merge (before)", beforeMs, to_string(before) + " triangles");
+
+    for (int threads = 1; ; threads = min(threads * 2, hardwareThreads())) {
+        start = BenchClock::now();
+        long long count = GraphAlgorithms::countTriangles(g, threads);
+        double ms = elapsedMs(start);
+        ostringstream extra;
+        extra << "x" << fixed << setprecision(1) << (ms > 0 ? beforeMs / ms : 0.0)
+            << (count == before ? "" : "  [RESULT MISMATCH]");
+        printRow("compact-forward count, " + to_string(threads) + " thr", ms, extra.str());
+
+        start = BenchClock::now();
+        size_t listed = GraphAlgorithms::findTriangles(g, threads).size();
+        printRow("compact-forward list, " + to_string(threads) + " thr", elapsedMs(start),
+            listed == static_cast<size_t>(before) ? "" : "[RESULT MISMATCH]");
+        if (threads >= hardwareThreads()) break;
+    }
+}
+
+void benchmarkIntersection(int smallSize, int repeats) {
+    cout << "\n[intersection] small set=" << smallSize << " repeats=" << repeats
+        << " simd=" << simdKind() << endl;
+
+    mt19937 rng(29);
+    auto sortedSet = [&rng](size_t size, int range) {
+        uniform_int_distribution<int> pick(0, range - 1);
+        vector<int> v(size);
+        for (auto& x : v) x = pick(rng);
+        sort(v.begin(), v.end());
+        v.erase(unique(v.begin(), v.end()), v.end());
+        return v;
+        };
+    const pair<const char*, IntersectMethod> methods[] = {
+        { "merge", IntersectMethod::Merge }, { "galloping", IntersectMethod::Galloping },
+        { "simd", IntersectMethod::Simd }, { "auto", IntersectMethod::Auto } };
+
+    for (int ratio : { 1, 4, 16, 64, 256, 1024 }) {
+        // Both sets drawn from a range twice the large size: about half overlap.
+        int largeSize = smallSize * ratio;
+        vector<int> a = sortedSet(smallSize, 2 * largeSize), b = sortedSet(largeSize, 2 * largeSize);
+        cout << "  ratio 1:" << ratio << endl;
+        for (const auto& m : methods) {
+            size_t found = 0;
+            auto start = BenchClock::now();
+            for (int r = 0; r < repeats; ++r)
+                found += intersectCount(a.data(), a.size(), b.data(), b.size(), m.second);
+            double ms = elapsedMs(start);
+            printRow(string("  ") + m.first, ms, "for all calls, " + to_string(found / repeats) + " common");
+        }
+    }
+}
+
+void benchmarkCloseFriends(int userCount, int friendshipCount, int queries) {
+    cout << "\n[close friends] users=" << userCount << " edges=" << friendshipCount
+        << " queries=" << queries << endl;
+
+    SocialNetwork net;
+    buildRandomFriendships(net, userCount, friendshipCount, 42);
+    // addFriendship stores both directions; mirror the one-way edges the same way.
+    for (auto* e : vector<Edge*>(net.getEdgesOfKind(EdgeKind::Friendship)))
+        if (!net.hasEdge(e->getTo(), e->getFrom(), EdgeKind::Friendship))
+            net.addEdge(new Friendship(e->getTo(), e->getFrom()));
+
+    // The best-connected users: thousands of friends each.
+    vector<int> byDegree(userCount);
+    for (int i = 0; i < userCount; ++i) byDegree[i] = i;
+    partial_sort(byDegree.begin(), byDegree.begin() + queries, byDegree.end(), [&net](int a, int b) {
+        return net.getNeighbors(a).size() > net.getNeighbors(b).size();
+        });
+    byDegree.resize(queries);
+    cout << "  friends per user up to " << net.getNeighbors(byDegree[0]).size() << endl;
+
+    // Before: friends of every friend through getNeighbors, deduplicated in a set.
+    size_t foundBefore = 0;
+    auto start = BenchClock::now();
+    for (int id : byDegree) {
+        set<int> closeSet;
+        for (int f : net.getNeighbors(id))
+            for (int ff : net.getNeighbors(f))
+                if (ff != id) closeSet.insert(ff);
+        foundBefore += closeSet.size();
+    }
+    double beforeMs = elapsedMs(start);
+    printRow("neighbor scans + set (before)", beforeMs / queries, "per query");
+
+    size_t foundAfter = 0;
+    start = BenchClock::now();
+    for (int id : byDegree)
+        foundAfter += net.closeFriendCounts(id).size();
+    double afterMs = elapsedMs(start);
+    printRow("stamped two-hop counts (after)", afterMs / queries, "per query");
+
+    cout << "  speedup x" << setprecision(1) << (afterMs > 0 ? beforeMs / afterMs : 0.0)
+        << (foundBefore == foundAfter ? "" : "  [RESULT MISMATCH]") << endl;
+}
+
+void benchmarkRecommendations(int userCount, int friendshipCount, int queries) {
+    cout << "\n[recommend] users=" << userCount << " edges=" << friendshipCount
+        << " queries=" << queries << " hardware threads=" << hardwareThreads() << endl;
+
+    SocialNetwork net;
+    buildRandomFriendships(net, userCount, friendshipCount, 42);
+    const int k = 10;
+
+    mt19937 rng(31);
+    uniform_int_distribution<int> pick(0, userCount - 1);
+    vector<int> users(queries);
+    for (auto& u : users) u = pick(rng);
+
+    // Before: Adamic-Adar scores in a map over the friend lists, then a full sort.
+    double checksumBefore = 0;
+    auto start = BenchClock::now();
+    for (int u : users) {
+        // Friendship is mutual: both edge directions count, parallel edges once.
+        auto friendsOf = [&net](int id) {
+            auto out = net.getNeighbors(id), in = net.getInNeighbors(id);
+            set<int> all(out.begin(), out.end());
+            all.insert(in.begin(), in.end());
+            return all;
+        };
+        set<int> friendIds = friendsOf(u);
+        map<int, double> score;
+        for (int f : friendIds) {
+            set<int> second = friendsOf(f);
+            if (second.size() < 2) continue;
+            for (int c : second)
+                if (c != u && !friendIds.count(c))
+                    score[c] += 1.0 / log(static_cast<double>(second.size()));
+        }
+        vector<pair<double, int>> ranked;
+        for (auto& entry : score) ranked.push_back({ entry.second, -entry.first });
+        sort(ranked.rbegin(), ranked.rend());
+        for (size_t i = 0; i < ranked.size() && i < static_cast<size_t>(k); ++i) checksumBefore += ranked[i].first;
+    }
+    double beforeMs = elapsedMs(start);
+    printRow("map + full sort (before)", beforeMs / queries, "per user");
+
+    // After: stamped scores and a bounded heap, one user at a time.
+    double checksumAfter = 0;
+    start = BenchClock::now();
+    for (int u : users)
+        for (const auto& r : net.recommend(u, k))
+            checksumAfter += r.score;
+    double afterMs = elapsedMs(start);
+    ostringstream extra;
+    extra << "per user, x" << fixed << setprecision(1) << (afterMs > 0 ? beforeMs / afterMs : 0.0)
+        << (abs(checksumBefore - checksumAfter) <= 1e-6 * checksumBefore ? "" : "  [RESULT MISMATCH]");
+    printRow("bounded heap (after)", afterMs / queries, extra.str());
+
+    // Batch mode: every user in one parallel pass.
+    for (int threads = 1; ; threads = min(threads * 2, hardwareThreads())) {
+        net.setThreadCount(threads);
+        start = BenchClock::now();
+        auto all = net.recommendAll(k);
+        double ms = elapsedMs(start);
+        printRow("recommendAll, " + to_string(threads) + " thr", ms / all.size(),
+            "per user, " + to_string(all.size()) + " users");
+        if (threads >= hardwareThreads()) break;
+    }
+}
+
+void benchmarkPageRank(int userCount, int subscriptionCount) {
+    cout << "\n[pagerank] users=" << userCount << " subscriptions=" << subscriptionCount
+        << " hardware threads=" << hardwareThreads() << endl;
+
+    // Followers are uniform, followees skewed towards a few popular users.
+    // Arcs run followee -> follower, as followerGraph() builds them.
+    mt19937 rng(19);
+    uniform_int_distribution<int> pick(0, userCount - 1);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    auto popular = [&]() { double x = unit(rng); return static_cast<int>(userCount * x * x * x); };
+    vector<pair<int, int>> arcs(subscriptionCount);
+    for (auto& a : arcs) a = { popular(), pick(rng) };
+    vector<int> ids(userCount);
+    for (int i = 0; i < userCount; ++i) ids[i] = i;
+
+    auto start = BenchClock::now();
+    CsrGraph g = CsrGraph::fromArcs(arcs, ids);
+    printRow("build follower CSR", elapsedMs(start), to_string(g.edgeCount()) + " distinct arcs");
+
+    SearchWorkspace ws;
+    start = BenchClock::now();
+    GraphAlgorithms::computeDegreeCentrality(g, ws);
+    printRow("degree count (old ranking)", elapsedMs(start));
+
+    PageRank rank;
+    for (int threads = 1; ; threads = min(threads * 2, hardwareThreads())) {
+        start = BenchClock::now();
+        int iterations = rank.run(g, threads, false);
+        double ms = elapsedMs(start);
+        ostringstream extra;
+        extra << iterations << " iterations, " << fixed << setprecision(2) << ms / iterations << " ms each";
+        printRow("PageRank cold, " + to_string(threads) + " thr", ms, extra.str());
+        if (threads >= hardwareThreads()) break;
+    }
+    auto before = rank.top(10);
+
+    // A burst of new subscriptions, then a warm and a cold rerun.
+    for (int i = 0; i < 1000; ++i) arcs.push_back({ popular(), pick(rng) });
+    g = CsrGraph::fromArcs(arcs, ids);
+    PageRank cold;
+    start = BenchClock::now();
+    int coldIterations = cold.run(g, 0, false);
+    double coldMs = elapsedMs(start);
+    printRow("after +1000 arcs, cold", coldMs, to_string(coldIterations) + " iterations");
+    start = BenchClock::now();
+    int warmIterations = rank.run(g, 0, true);
+    double warmMs = elapsedMs(start);
+    ostringstream extra;
+    extra << warmIterations << " iterations, x" << fixed << setprecision(1) << (warmMs > 0 ? coldMs / warmMs : 0.0);
+    double gap = 0;
+    for (const auto& entry : cold.top(10)) gap = max(gap, fabs(entry.second - rank.rankOf(entry.first)));
+    if (gap > 1e-6) extra << "  [RESULT MISMATCH]";
+    printRow("after +1000 arcs, warm", warmMs, extra.str());
+    cout << "  top user " << before[0].first << " rank " << before[0].second << endl;
+}
+
+void benchmarkBetweenness(int vertexCount, int edgeCount, int samples) {
+    cout << "\n[betweenness] vertices=" << vertexCount << " edges=" << edgeCount
+        << " samples=" << samples << " hardware threads=" << hardwareThreads() << endl;
+
+    mt19937 rng(29);
+    uniform_int_distribution<int> pick(0, vertexCount - 1);
+    vector<pair<int, int>> edges(edgeCount);
+    for (auto& e : edges) e = { pick(rng), pick(rng) };
+    CsrGraph g = CsrGraph::fromEdges(edges);
+    int n = g.vertexCount();
+
+    // Before: textbook Brandes with a predecessor list per vertex, fresh
+    // buffers for every source, one thread.
+    vector<double> before(n, 0.0);
+    auto start = BenchClock::now();
+    for (int s = 0; s < n; ++s) {
+        vector<vector<int>> preds(n);
+        vector<double> sigma(n, 0), delta(n, 0);
+        vector<int> dist(n, -1), stack;
+        queue<int> q;
+        sigma[s] = 1;
+        dist[s] = 0;
+        q.push(s);
+        while (!q.empty()) {
+            int u = q.front();
+            q.pop();
+            stack.push_back(u);
+            for (int v : g.neighbors(u)) {
+                if (dist[v] < 0) {
+                    dist[v] = dist[u] + 1;
+                    q.push(v);
+                }
+                if (dist[v] == dist[u] + 1) {
+                    sigma[v] += sigma[u];
+                    preds[v].push_back(u);
+                }
+            }
+        }
+        while (!stack.empty()) {
+            int w = stack.back();
+            stack.pop_back();
+            for (int v : preds[w]) delta[v] += sigma[v] / sigma[w] * (1 + delta[w]);
+            if (w != s) before[w] += delta[w] / 2;
+        }
+    }
+    double beforeMs = elapsedMs(start);
+    printRow("textbook Brandes (before)", beforeMs);
+
+    SearchWorkspace ws;
+    for (int threads = 1; ; threads = min(threads * 2, hardwareThreads())) {
+        start = BenchClock::now();
+        auto exact = GraphAlgorithms::betweennessCentrality(g, ws, 0, threads);
+        double ms = elapsedMs(start);
+        double gap = 0;
+        for (int v = 0; v < n; ++v) gap = max(gap, fabs(exact.valueAt(v) - before[v]));
+        ostringstream extra;
+        extra << "x" << fixed << setprecision(1) << (ms > 0 ? beforeMs / ms : 0.0)
+            << (gap <= 1e-6 * n ? "" : "  [RESULT MISMATCH]");
+        printRow("exact, " + to_string(threads) + " thr", ms, extra.str());
+        if (threads >= hardwareThreads()) break;
+    }
+
+    start = BenchClock::now();
+    auto sampled = GraphAlgorithms::betweennessCentrality(g, ws, samples);
+    double ms = elapsedMs(start);
+    double worst = 0, peak = 0;
+    for (int v = 0; v < n; ++v) {
+        worst = max(worst, fabs(sampled.valueAt(v) - before[v]));
+        peak = max(peak, before[v]);
+    }
+    ostringstream extra;
+    extra << "x" << fixed << setprecision(1) << (ms > 0 ? beforeMs / ms : 0.0)
+        << ", worst error " << setprecision(0) << worst << " (bound " << GraphAlgorithms::betweennessErrorBound(n, samples)
+        << ", top score " << peak << ")";
+    printRow("sampled, " + to_string(samples) + " sources", ms, extra.str());
+}
+
+void benchmarkCommunities(int vertexCount, int edgeCount, int groupSize) {
+    cout << "\n[communities] vertices=" << vertexCount << " edges=" << edgeCount
+        << " planted group size=" << groupSize << " hardware threads=" << hardwareThreads() << endl;
+
+    // Planted groups: 80% of the edges stay inside a group.
+    mt19937 rng(37);
+    uniform_int_distribution<int> pick(0, vertexCount - 1), member(0, groupSize - 1);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    vector<pair<int, int>> edges(edgeCount);
+    for (auto& e : edges) {
+        int a = pick(rng);
+        int b = unit(rng) < 0.8 ? min(a / groupSize * groupSize + member(rng), vertexCount - 1) : pick(rng);
+        e = { a, b };
+    }
+    for (size_t i = 0, m = edges.size(); i < m; ++i)
+        edges.push_back({ edges[i].second, edges[i].first });
+    vector<int> ids(vertexCount);
+    for (int i = 0; i < vertexCount; ++i) ids[i] = i;
+    auto start = BenchClock::now();
+    CsrGraph g = CsrGraph::fromArcs(edges, ids);
+    printRow("build snapshot", elapsedMs(start));
+
+    start = BenchClock::now();
+    size_t triangles = GraphAlgorithms::findTriangles(g).size();
+    printRow("triangles as groups (before)", elapsedMs(start), to_string(triangles) + " overlapping groups");
+
+    for (auto method : { CommunityMethod::LabelPropagation, CommunityMethod::Louvain }) {
+        string name = method == CommunityMethod::Louvain ? "Louvain" : "label propagation";
+        for (int threads = 1; ; threads = min(threads * 2, hardwareThreads())) {
+            start = BenchClock::now();
+            auto communities = Communities::detect(g, method, threads);
+            double ms = elapsedMs(start);
+            ostringstream extra;
+            extra << communities.count() << " communities, modularity " << fixed << setprecision(3)
+                << communities.modularity();
+            printRow(name + ", " + to_string(threads) + " thr", ms, extra.str());
+            if (threads >= hardwareThreads()) break;
+        }
+    }
+}
+
+void benchmarkCores(int vertexCount, int edgeCount) {
+    cout << "\n[cores] vertices=" << vertexCount << " edges=" << edgeCount
+        << " hardware threads=" << hardwareThreads() << endl;
+
+    mt19937 rng(41);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    auto skewed = [&]() { double x = unit(rng); return static_cast<int>(vertexCount * x * x); };
+    vector<pair<int, int>> arcs;
+    arcs.reserve(2 * static_cast<size_t>(edgeCount));
+    for (int i = 0; i < edgeCount; ++i) {
+        int a = skewed(), b = skewed();
+        if (a == b) continue;
+        arcs.push_back({ a, b });
+        arcs.push_back({ b, a });
+    }
+    vector<int> ids(vertexCount);
+    for (int i = 0; i < vertexCount; ++i) ids[i] = i;
+    CsrGraph g = CsrGraph::fromArcs(arcs, ids);
+    int n = g.vertexCount();
+
+    // Before: repeatedly take the minimum-degree vertex out of an ordered set.
+    auto start = BenchClock::now();
+    vector<int> before(n), degree(n);
+    set<pair<int, int>> byDegree;
+    for (int v = 0; v < n; ++v) {
+        degree[v] = g.degree(v);
+        byDegree.insert({ degree[v], v });
+    }
+    int level = 0;
+    while (!byDegree.empty()) {
+        auto [d, v] = *byDegree.begin();
+        byDegree.erase(byDegree.begin());
+        level = max(level, d);
+        before[v] = level;
+        degree[v] = -1;
+        for (int u : g.neighbors(v)) {
+            if (degree[u] <= d) continue;
+            byDegree.erase({ degree[u], u });
+            byDegree.insert({ --degree[u], u });
+        }
+    }
+    double beforeMs = elapsedMs(start);
+    printRow("ordered-set peeling (before)", beforeMs, "max core " + to_string(level));
+
+    // One thread runs the bucket algorithm; peeling always gets at least two.
+    for (int threads : { 1, max(2, hardwareThreads()) }) {
+        start = BenchClock::now();
+        auto cores = GraphAlgorithms::coreDecomposition(g, threads);
+        double ms = elapsedMs(start);
+        ostringstream extra;
+        extra << "x" << fixed << setprecision(1) << (ms > 0 ? beforeMs / ms : 0.0)
+            << (cores == before ? "" : "  [RESULT MISMATCH]");
+        printRow(string(threads == 1 ? "buckets" : "parallel peeling") + ", " + to_string(threads) + " thr", ms, extra.str());
+    }
+
+    // The engaged core as a view against a materialized copy.
+    int k = level / 2;
+    start = BenchClock::now();
+    CsrSubgraph view(g, before, k);
+    double viewMs = elapsedMs(start);
+    start = BenchClock::now();
+    vector<pair<int, int>> kept;
+    for (int v = 0; v < n; ++v)
+        if (view.contains(v))
+            for (int u : view.neighbors(v)) kept.push_back({ v, u });
+    CsrGraph copy = CsrGraph::fromArcs(kept, g.vertexIds());
+    printRow(to_string(k) + "-core as a copy", elapsedMs(start), to_string(copy.vertexCount()) + " users");
+    printRow(to_string(k) + "-core as a view", viewMs, to_string(view.vertexCount()) + " users, no edges copied");
+}
+
+void benchmarkStrongComponents(int vertexCount, int arcCount) {
+    cout << "\n[scc] vertices=" << vertexCount << " arcs=" << arcCount << endl;
+
+    vector<int> ids(vertexCount);
+    for (int i = 0; i < vertexCount; ++i) ids[i] = i;
+
+    // A single chain: the recursive search went one frame per vertex.
+    vector<pair<int, int>> chain;
+    for (int i = 0; i + 1 < vertexCount; ++i) {
+        chain.push_back({ i, i + 1 });
+        chain.push_back({ i + 1, i });
+    }
+    CsrGraph path = CsrGraph::fromArcs(chain, ids);
+    auto start = BenchClock::now();
+    bool cyclic = GraphAlgorithms::hasCycle(path);
+    printRow("cycle check, " + to_string(vertexCount) + "-long chain", elapsedMs(start),
+        cyclic ? "[RESULT MISMATCH]" : "no cycle, no recursion");
+
+    // Random follows: a giant strong component plus many small ones.
+    mt19937 rng(43);
+    uniform_int_distribution<int> pick(0, vertexCount - 1);
+    vector<pair<int, int>> arcs(arcCount);
+    for (auto& a : arcs) a = { pick(rng), pick(rng) };
+    CsrGraph g = CsrGraph::fromArcs(arcs, ids);
+    start = BenchClock::now();
+    int count = 0;
+    auto component = GraphAlgorithms::stronglyConnectedComponents(g, &count);
+    double ms = elapsedMs(start);
+    vector<int> sizes(count, 0);
+    for (int c : component) ++sizes[c];
+    printRow("iterative Tarjan", ms, to_string(count) + " components, largest "
+        + to_string(*max_element(sizes.begin(), sizes.end())));
+
+    // One directed loop through every vertex: the deepest possible search.
+    for (int i = 0; i < vertexCount; ++i) arcs[i] = { i, (i + 1) % vertexCount };
+    arcs.resize(vertexCount);
+    CsrGraph ring = CsrGraph::fromArcs(arcs, ids);
+    start = BenchClock::now();
+    GraphAlgorithms::stronglyConnectedComponents(ring, &count);
+    printRow("iterative Tarjan, one long loop", elapsedMs(start), count == 1 ? "1 component" : "[RESULT MISMATCH]");
+}
+
+void benchmarkNeighborhood(int vertexCount, int edgeCount, int samples) {
+    cout << "\n[anf] vertices=" << vertexCount << " edges=" << edgeCount
+        << " register max=" << simdKind() << endl;
+
+    mt19937 rng(47);
+    uniform_int_distribution<int> pick(0, vertexCount - 1);
+    vector<pair<int, int>> arcs;
+    arcs.reserve(2 * static_cast<size_t>(edgeCount));
+    for (int i = 0; i < edgeCount; ++i) {
+        int a = pick(rng), b = pick(rng);
+        arcs.push_back({ a, b });
+        arcs.push_back({ b, a });
+    }
+    vector<int> ids(vertexCount);
+    for (int i = 0; i < vertexCount; ++i) ids[i] = i;
+    CsrGraph g = CsrGraph::fromArcs(arcs, ids);
+
+    // Baseline: one BFS per user, timed on a sample and scaled to everyone.
+    // Sources are dense indices: users without edges are not in the snapshot.
+    const int hops = 2;
+    int n = g.vertexCount();
+    uniform_int_distribution<int> pickVertex(0, n - 1);
+    vector<int> distance(n, -1), queue, sources(samples), exactReach(samples);
+    for (auto& s : sources) s = pickVertex(rng);
+    vector<double> sampledPairs;
+    auto start = BenchClock::now();
+    for (int i = 0; i < samples; ++i) {
+        queue.assign(1, sources[i]);
+        distance[sources[i]] = 0;
+        for (size_t head = 0; head < queue.size(); ++head)
+            for (int u : g.neighbors(queue[head]))
+                if (distance[u] < 0) {
+                    distance[u] = distance[queue[head]] + 1;
+                    queue.push_back(u);
+                }
+        for (int v : queue) {
+            int d = distance[v];
+            if (d <= hops) ++exactReach[i];
+            if (static_cast<int>(sampledPairs.size()) <= d) sampledPairs.resize(d + 1, 0.0);
+            sampledPairs[d] += static_cast<double>(n) / samples;
+            distance[v] = -1;
+        }
+    }
+    double bfsMs = elapsedMs(start) * n / samples;
+    for (size_t d = 1; d < sampledPairs.size(); ++d) sampledPairs[d] += sampledPairs[d - 1];
+    printRow("BFS per user (extrapolated from " + to_string(samples) + ")", bfsMs, "");
+
+    start = BenchClock::now();
+    auto anf = NeighborhoodFunction::compute(g, hops, 6, hardwareThreads());
+    double ms = elapsedMs(start);
+    double error = 0;
+    for (int i = 0; i < samples; ++i)
+        error += fabs(anf.reachByVertex()[sources[i]] - exactReach[i]) / exactReach[i];
+    ostringstream note;
+    note << fixed << setprecision(2) << anf.neighborhood().size() - 1 << " passes, "
+        << hops << "-hop reach error " << 100 * error / samples << "% (bound ~"
+        << 100 * anf.relativeError() << "%), x" << bfsMs / ms;
+    printRow("HyperANF, 64 registers", ms, note.str());
+
+    double sampledDiameter = 0, target = 0.9 * sampledPairs.back();
+    for (size_t t = 0; t < sampledPairs.size(); ++t)
+        if (sampledPairs[t] >= target) {
+            sampledDiameter = t ? (t - 1) + (target - sampledPairs[t - 1]) / (sampledPairs[t] - sampledPairs[t - 1]) : 0.0;
+            break;
+        }
+    cout << "  " << fixed << setprecision(2) << "effective diameter " << anf.effectiveDiameter()
+        << " (sampled BFS " << sampledDiameter << "), average distance " << anf.averageDistance() << endl;
+}
+
+void runBenchmarks(const string& filter) {
+    LOG_INFO("Running benchmarks" + (filter.empty() ? string() : " matching '" + filter + "'"));
+    auto selected = [&filter](const string& name) {
+        return filter.empty() || name.find(filter) != string::npos;
+        };
+
+    if (selected("friends"))
+        benchmarkFriendOfFriend(100000, 1000000, 20);
+    if (selected("alloc"))
+        benchmarkAllocation(200000);
+    if (selected("search"))
+        benchmarkSearchResults(100000, 1000000, 20);
+    if (selected("bfs"))
+        benchmarkParallelBfs(1000000, 8000000, 10);
+    if (selected("path"))
+        benchmarkPointToPoint(100000, 1000000, 200);
+    if (selected("connect"))
+        benchmarkConnectivity(100000, 60000, 10000);
+    if (selected("sssp"))
+        benchmarkDeltaStepping(100000, 800000, 20);
+    if (selected("batch"))
+        benchmarkMultiSourceBfs(200000, 1600000, 128);
+    if (selected("oracle"))
+        benchmarkDistanceOracle(100000, 1000000, 2000);
+    if (selected("triangles"))
+        benchmarkTriangles(200000, 2000000);
+    if (selected("intersect"))
+        benchmarkIntersection(1000, 2000);
+    if (selected("close"))
+        benchmarkCloseFriends(4000, 4000000, 20);
+    if (selected("recommend"))
+        benchmarkRecommendations(100000, 1000000, 200);
+    if (selected("pagerank"))
+        benchmarkPageRank(2000000, 20000000);
+    if (selected("betweenness"))
+        benchmarkBetweenness(5000, 25000, 256);
+    if (selected("communities"))
+        benchmarkCommunities(1000000, 5000000, 100);
+    if (selected("cores"))
+        benchmarkCores(1000000, 8000000);
+    if (selected("scc"))
+        benchmarkStrongComponents(1000000, 5000000);
+    if (selected("anf"))
+        benchmarkNeighborhood(1000000, 5000000, 50);
+
+    LOG_INFO("Benchmarks finished");
+}
@@ -0,0 +1,31 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+using namespace std;
+
+// Performance benchmarks, started with the --bench command line flag.
+// Results are printed to stdout; logging is lowered to WARN while they run.
+void runBenchmarks(const string& filter = "");
+
+void benchmarkFriendOfFriend(int userCount, int friendshipCount, int queries);
+void benchmarkAllocation(int userCount);
+void benchmarkSearchResults(int userCount, int friendshipCount, int queries);
+void benchmarkParallelBfs(int vertexCount, int edgeCount, int queries);
+void benchmarkPointToPoint(int userCount, int friendshipCount, int queries);
+void benchmarkConnectivity(int userCount, int friendshipCount, int queries);
+void benchmarkDeltaStepping(int userCount, int friendshipCount, int queries);
+void benchmarkMultiSourceBfs(int vertexCount, int edgeCount, int sourceCount);
+void benchmarkDistanceOracle(int userCount, int friendshipCount, int queries);
+void benchmarkTriangles(int vertexCount, int edgeCount);
+void benchmarkIntersection(int smallSize, int repeats);
+void benchmarkCloseFriends(int userCount, int friendshipCount, int queries);
+void benchmarkRecommendations(int userCount, int friendshipCount, int queries);
+void benchmarkPageRank(int userCount, int subscriptionCount);
+void benchmarkBetweenness(int vertexCount, int edgeCount, int samples);
+void benchmarkCommunities(int vertexCount, int edgeCount, int groupSize);
+void benchmarkCores(int vertexCount, int edgeCount);
+void benchmarkStrongComponents(int vertexCount, int arcCount);
+void benchmarkNeighborhood(int vertexCount, int edgeCount, int samples);
+
+#endif // BENCHMARK_H
@@ -0,0 +1,314 @@
+#include "Communities.h"
+#include <algorithm>
+#include <cstdint>
+#include "Parallel.h"
+
+static const size_t VerticesPerChunk = 2048;
+static const int MaxPropagationRounds = 30;
+static const int MaxMoveSweeps = 32;
+static const int MaxLevels = 16;
+// Stop once fewer than n / ChangeFraction vertices move in a round.
+static const size_t ChangeFraction = 1000;
+
+static uint32_t mix(uint32_t x, uint32_t salt) {
+    x ^= salt * 0x9E3779B9u;
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    return x ^ (x >> 16);
+}
+
+// Rounds update the vertices in two halves: a vertex never reads a label
+// written in the same half, and neighbors seldom flip in lockstep.
+static bool inHalf(int v, int half, uint32_t salt) {
+    return static_cast<int>(mix(static_cast<uint32_t>(v), salt) & 1) == half;
+}
+
+// Sparse per-worker tally keyed by label or community.
+template <typename T>
+struct Tally {
+    vector<T> value;
+    vector<int> touched;
+    explicit Tally(size_t n) : value(n, T()) {}
+    void add(int key, T amount) {
+        if (value[key] == T()) touched.push_back(key);
+        value[key] += amount;
+    }
+    void clear() {
+        for (int key : touched) value[key] = T();
+        touched.clear();
+    }
+};
+
+static vector<int> propagateLabels(const CsrGraph& g, int threads, unsigned seed) {
+    int n = g.vertexCount();
+    vector<int> labels(n), next(n);
+    vector<char> active(n, 1);
+    for (int v = 0; v < n; ++v) labels[v] = next[v] = v;
+
+    ScratchPool<Tally<int>> pool;
+    for (int round = 0; round < MaxPropagationRounds; ++round) {
+        size_t changed = 0;
+        for (int half = 0; half < 2; ++half) {
+            uint32_t salt = seed * 2654435761u + round;
+            parallelFor(threads, n, VerticesPerChunk, [&](size_t begin, size_t end) {
+                Tally<int>* tally = pool.acquire([n] { return new Tally<int>(n); });
+                for (size_t v = begin; v < end; ++v) {
+                    if (!active[v] || !inHalf(static_cast<int>(v), half, salt)) continue;
+                    active[v] = 0;
+                    for (int u : g.neighbors(static_cast<int>(v)))
+                        if (u != static_cast<int>(v)) tally->add(labels[u], 1);
+                    // Keep the current label when it ties for the lead;
+                    // otherwise a hash of label and round breaks the tie.
+                    int best = labels[v], bestCount = tally->value[best];
+                    uint32_t bestRank = 0;
+                    bool kept = true;
+                    for (int l : tally->touched) {
+                        int c = tally->value[l];
+                        if (c < bestCount || (c == bestCount && kept)) continue;
+                        uint32_t rank = mix(static_cast<uint32_t>(l), salt);
+                        if (c > bestCount || rank < bestRank) {
+                            best = l;
+                            bestCount = c;
+                            bestRank = rank;
+                            kept = false;
+                        }
+                    }
+                    tally->clear();
+                    next[v] = best;
+                }
+                pool.release(tally);
+                });
+            // Only vertices next to a change can change in the next half.
+            for (int v = 0; v < n; ++v) {
+                if (next[v] == labels[v]) continue;
+                labels[v] = next[v];
+                ++changed;
+                for (int u : g.neighbors(v)) active[u] = 1;
+            }
+        }
+        if (changed * ChangeFraction <= static_cast<size_t>(n)) break;
+    }
+    return labels;
+}
+
+// Weighted undirected graph for one Louvain level. loop[v] holds the
+// weight folded into v by earlier levels (both directions), strength[v]
+// the weighted degree including it.
+struct LevelGraph {
+    vector<int> offsets, targets;
+    vector<double> weights, loop, strength;
+    int size() const { return static_cast<int>(loop.size()); }
+};
+
+static LevelGraph levelOf(const CsrGraph& g) {
+    LevelGraph level;
+    int n = g.vertexCount();
+    level.offsets.assign(n + 1, 0);
+    level.loop.assign(n, 0.0);
+    level.strength.assign(n, 0.0);
+    for (int v = 0; v < n; ++v) {
+        for (int u : g.neighbors(v))
+            if (u != v) level.targets.push_back(u);
+        level.offsets[v + 1] = static_cast<int>(level.targets.size());
+        level.strength[v] = level.offsets[v + 1] - level.offsets[v];
+    }
+    level.weights.assign(level.targets.size(), 1.0);
+    return level;
+}
+
+// Greedy modularity moves until a sweep moves almost nothing. Best moves
+// for one half are found in parallel against fixed community totals,
+// then applied in one pass. Only vertices next to a move are looked at
+// again. Returns whether anything moved.
+static bool moveVertices(const LevelGraph& level, vector<int>& community, double twoM, int threads, unsigned seed) {
+    int n = level.size();
+    vector<double> total(level.strength);
+    vector<int> target(n);
+    vector<char> active(n, 1);
+    for (int v = 0; v < n; ++v) community[v] = v;
+
+    ScratchPool<Tally<double>> pool;
+    bool movedAny = false;
+    for (int sweep = 0; sweep < MaxMoveSweeps; ++sweep) {
+        size_t moved = 0;
+        for (int half = 0; half < 2; ++half) {
+            uint32_t salt = seed * 2654435761u + sweep;
+            parallelFor(threads, n, VerticesPerChunk, [&](size_t begin, size_t end) {
+                Tally<double>* tally = pool.acquire([n] { return new Tally<double>(n); });
+                for (size_t i = begin; i < end; ++i) {
+                    int v = static_cast<int>(i);
+                    target[v] = community[v];
+                    if (!active[v] || !inHalf(v, half, salt)) continue;
+                    active[v] = 0;
+                    for (int e = level.offsets[v]; e < level.offsets[v + 1]; ++e)
+                        tally->add(community[level.targets[e]], level.weights[e]);
+                    // Gain of joining c, up to terms that do not depend on c.
+                    double k = level.strength[v];
+                    int own = community[v];
+                    int best = own;
+                    double bestGain = tally->value[own] - (total[own] - k) * k / twoM;
+                    for (int c : tally->touched) {
+                        if (c == own) continue;
+                        double gain = tally->value[c] - total[c] * k / twoM;
+                        if (gain > bestGain + 1e-12 || (gain > bestGain - 1e-12 && best != own && c < best)) {
+                            best = c;
+                            bestGain = gain;
+                        }
+                    }
+                    tally->clear();
+                    target[v] = best;
+                }
+                pool.release(tally);
+                });
+            for (int v = 0; v < n; ++v) {
+                if (target[v] == community[v]) continue;
+                total[community[v]] -= level.strength[v];
+                total[target[v]] += level.strength[v];
+                community[v] = target[v];
+                ++moved;
+                active[v] = 1;
+                for (int e = level.offsets[v]; e < level.offsets[v + 1]; ++e)
+                    active[level.targets[e]] = 1;
+            }
+        }
+        if (moved) movedAny = true;
+        if (moved * ChangeFraction <= static_cast<size_t>(n)) break;
+    }
+    return movedAny;
+}
+
+// Collapses each community into one vertex; renumbers community to 0..c-1.
+static LevelGraph aggregate(const LevelGraph& level, vector<int>& community) {
+    int n = level.size();
+    vector<int> renumber(n, -1);
+    int count = 0;
+    for (int v = 0; v < n; ++v)
+        if (renumber[community[v]] < 0) renumber[community[v]] = count++;
+    for (int v = 0; v < n; ++v) community[v] = renumber[community[v]];
+
+    vector<int> start(count + 1, 0), members(n);
+    for (int v = 0; v < n; ++v) ++start[community[v] + 1];
+    for (int c = 0; c < count; ++c) start[c + 1] += start[c];
+    vector<int> fill(start.begin(), start.end() - 1);
+    for (int v = 0; v < n; ++v) members[fill[community[v]]++] = v;
+
+    LevelGraph coarse;
+    coarse.offsets.assign(count + 1, 0);
+    coarse.loop.assign(count, 0.0);
+    coarse.strength.assign(count, 0.0);
+    Tally<double> tally(count);
+    for (int c = 0; c < count; ++c) {
+        for (int i = start[c]; i < start[c + 1]; ++i) {
+            int v = members[i];
+            coarse.loop[c] += level.loop[v];
+            coarse.strength[c] += level.strength[v];
+            for (int e = level.offsets[v]; e < level.offsets[v + 1]; ++e) {
+                int d = community[level.targets[e]];
+                if (d == c) coarse.loop[c] += level.weights[e];
+                else tally.add(d, level.weights[e]);
+            }
+        }
+        sort(tally.touched.begin(), tally.touched.end());
+        for (int d : tally.touched) {
+            coarse.targets.push_back(d);
+            coarse.weights.push_back(tally.value[d]);
+        }
+        tally.clear();
+        coarse.offsets[c + 1] = static_cast<int>(coarse.targets.size());
+    }
+    return coarse;
+}
+
+static vector<int> louvain(const CsrGraph& g, int threads, unsigned seed) {
+    int n = g.vertexCount();
+    vector<int> labels(n);
+    for (int v = 0; v < n; ++v) labels[v] = v;
+    LevelGraph level = levelOf(g);
+    double twoM = 0;
+    for (double s : level.strength) twoM += s;
+    if (twoM == 0) return labels;
+
+    vector<int> community(n);
+    for (int depth = 0; depth < MaxLevels; ++depth) {
+        community.resize(level.size());
+        if (!moveVertices(level, community, twoM, threads, seed + depth)) break;
+        LevelGraph coarse = aggregate(level, community);
+        for (auto& l : labels) l = community[l];
+        bool shrank = coarse.size() < level.size();
+        level = move(coarse);
+        if (!shrank) break;
+    }
+    return labels;
+}
+
+void Communities::finish(const CsrGraph& g, const vector<int>& raw) {
+    int n = g.vertexCount();
+    // Connected pieces of each raw label, found by BFS inside the label.
+    vector<int> piece(n, -1), queue;
+    vector<int> pieceSize;
+    for (int s = 0; s < n; ++s) {
+        if (piece[s] >= 0) continue;
+        int id = static_cast<int>(pieceSize.size());
+        piece[s] = id;
+        queue.assign(1, s);
+        for (size_t head = 0; head < queue.size(); ++head)
+            for (int u : g.neighbors(queue[head]))
+                if (piece[u] < 0 && raw[u] == raw[s]) {
+                    piece[u] = id;
+                    queue.push_back(u);
+                }
+        pieceSize.push_back(static_cast<int>(queue.size()));
+    }
+
+    // Pieces are numbered by their lowest vertex, which is the lowest ID.
+    vector<int> order(pieceSize.size());
+    for (int p = 0; p < static_cast<int>(order.size()); ++p) order[p] = p;
+    stable_sort(order.begin(), order.end(), [&pieceSize](int a, int b) { return pieceSize[a] > pieceSize[b]; });
+    vector<int> rank(order.size());
+    for (int i = 0; i < static_cast<int>(order.size()); ++i) rank[order[i]] = i;
+
+    label.resize(n);
+    stats.assign(order.size(), CommunityStats());
+    vector<double> volume(order.size(), 0.0);
+    double twoM = 0;
+    for (int v = 0; v < n; ++v) {
+        int c = label[v] = rank[piece[v]];
+        ++stats[c].size;
+        for (int u : g.neighbors(v)) {
+            if (u == v) continue;
+            volume[c] += 1;
+            twoM += 1;
+            if (rank[piece[u]] != c) ++stats[c].boundaryEdges;
+            else if (u > v) ++stats[c].internalEdges;
+        }
+    }
+    score = 0;
+    if (twoM > 0)
+        for (size_t c = 0; c < stats.size(); ++c)
+            score += 2.0 * stats[c].internalEdges / twoM - (volume[c] / twoM) * (volume[c] / twoM);
+}
+
+Communities Communities::detect(const CsrGraph& g, CommunityMethod method, int threads, unsigned seed) {
+    Communities result;
+    result.ids = g.vertexIds();
+    result.index = g.indexMap();
+    auto raw = method == CommunityMethod::LabelPropagation ? propagateLabels(g, threads, seed) : louvain(g, threads, seed);
+    result.finish(g, raw);
+    return result;
+}
+
+int Communities::communityOf(int id) const {
+    auto it = index.find(id);
+    return it != index.end() ? label[it->second] : -1;
+}
+
+vector<vector<int>> Communities::groups() const {
+    vector<vector<int>> result(stats.size());
+    for (size_t c = 0; c < stats.size(); ++c) result[c].reserve(stats[c].size);
+    // Snapshot vertices are in ascending ID order, so each group is too.
+    for (size_t v = 0; v < label.size(); ++v)
+        result[label[v]].push_back(ids[v]);
+    return result;
+}
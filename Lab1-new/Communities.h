@@ -0,0 +1,57 @@
+#ifndef COMMUNITIES_H
+#define COMMUNITIES_H
+
+#include <vector>
+#include <unordered_map>
+#include "CsrGraph.h"
+using namespace std;
+
+enum class CommunityMethod {
+    // Each vertex takes the label most of its neighbors carry; fast, no
+    // objective, results vary more from run to run.
+    LabelPropagation,
+    // Louvain: greedy modularity moves, then communities merge into single
+    // vertices and the moves repeat on the smaller graph.
+    Louvain
+};
+
+struct CommunityStats {
+    int size = 0;
+    // Edges with both ends inside, and edges with exactly one.
+    long long internalEdges = 0;
+    long long boundaryEdges = 0;
+};
+
+// A partition of a snapshot's vertices into communities. Every community
+// is connected; communities are numbered by size, largest first, ties to
+// the one holding the lower vertex ID.
+class Communities {
+private:
+    vector<int> ids;
+    unordered_map<int, int> index;
+    vector<int> label;
+    vector<CommunityStats> stats;
+    double score = 0;
+
+    // Splits disconnected labels, renumbers and fills the stats.
+    void finish(const CsrGraph& g, const vector<int>& raw);
+
+public:
+    Communities() {}
+    static Communities detect(const CsrGraph& g, CommunityMethod method = CommunityMethod::Louvain,
+        int threads = 0, unsigned seed = 1);
+
+    size_t count() const { return stats.size(); }
+    // Community of an external ID; -1 when it is not in the snapshot.
+    int communityOf(int id) const;
+    // Community of every vertex, indexed like the snapshot.
+    const vector<int>& membership() const { return label; }
+    const vector<int>& vertexIds() const { return ids; }
+    const CommunityStats& statsOf(int community) const { return stats[community]; }
+    // Member IDs of each community, ascending, in community order.
+    vector<vector<int>> groups() const;
+    // Newman modularity of the partition, in [-0.5, 1).
+    double modularity() const { return score; }
+};
+
+#endif // COMMUNITIES_H
@@ -0,0 +1,163 @@
+#include "CsrGraph.h"
+#include <algorithm>
+
+CsrGraph::CsrGraph() : offsets(1, 0) {}
+
+int CsrGraph::indexOf(int id) const {
+    auto it = index.find(id);
+    return it != index.end() ? it->second : -1;
+}
+
+CsrGraph CsrGraph::fromAdjacency(const map<int, vector<int>>& adjacency) {
+    CsrGraph g;
+    g.ids.reserve(adjacency.size());
+    for (const auto& kv : adjacency) {
+        g.index[kv.first] = static_cast<int>(g.ids.size());
+        g.ids.push_back(kv.first);
+    }
+    // Neighbors that never appear as keys still need a dense index.
+    for (const auto& kv : adjacency)
+        for (int id : kv.second)
+            if (!g.index.count(id)) {
+                g.index[id] = static_cast<int>(g.ids.size());
+                g.ids.push_back(id);
+            }
+
+    int n = g.vertexCount();
+    vector<vector<int>> rows(n);
+    for (const auto& kv : adjacency) {
+        auto& row = rows[g.index[kv.first]];
+        row.reserve(kv.second.size());
+        for (int id : kv.second) row.push_back(g.index[id]);
+    }
+
+    g.offsets.assign(n + 1, 0);
+    for (int v = 0; v < n; ++v) {
+        auto& row = rows[v];
+        sort(row.begin(), row.end());
+        row.erase(unique(row.begin(), row.end()), row.end());
+        g.offsets[v + 1] = g.offsets[v] + static_cast<int>(row.size());
+    }
+    g.targets.reserve(g.offsets[n]);
+    for (auto& row : rows)
+        g.targets.insert(g.targets.end(), row.begin(), row.end());
+    return g;
+}
+
+CsrGraph CsrGraph::fromEdges(const vector<pair<int, int>>& edges, bool undirected) {
+    map<int, vector<int>> adjacency;
+    for (const auto& e : edges) {
+        adjacency[e.first].push_back(e.second);
+        if (undirected)
+            adjacency[e.second].push_back(e.first);
+        else
+            adjacency[e.second];
+    }
+    return fromAdjacency(adjacency);
+}
+
+CsrGraph CsrGraph::fromDense(const vector<vector<int>>& rows, const vector<int>& rowIds) {
+    CsrGraph g;
+    vector<int> live;
+    for (int s = 0; s < static_cast<int>(rows.size()); ++s)
+        if (!rows[s].empty()) live.push_back(s);
+    sort(live.begin(), live.end(), [&rowIds](int a, int b) { return rowIds[a] < rowIds[b]; });
+
+    vector<int> remap(rows.size(), -1);
+    g.ids.reserve(live.size());
+    for (int i = 0; i < static_cast<int>(live.size()); ++i) {
+        remap[live[i]] = i;
+        g.ids.push_back(rowIds[live[i]]);
+        g.index[rowIds[live[i]]] = i;
+    }
+
+    int n = g.vertexCount();
+    g.offsets.assign(n + 1, 0);
+    vector<int> row;
+    for (int v = 0; v < n; ++v) {
+        row.clear();
+        for (int s : rows[live[v]])
+            if (remap[s] >= 0) row.push_back(remap[s]);
+        sort(row.begin(), row.end());
+        row.erase(unique(row.begin(), row.end()), row.end());
+        g.targets.insert(g.targets.end(), row.begin(), row.end());
+        g.offsets[v + 1] = static_cast<int>(g.targets.size());
+    }
+    return g;
+}
+
+CsrGraph CsrGraph::fromArcs(const vector<pair<int, int>>& arcs, const vector<int>& slotIds) {
+    CsrGraph g;
+    vector<int> remap(slotIds.size(), -1);
+    vector<int> live;
+    for (const auto& a : arcs)
+        for (int s : { a.first, a.second })
+            if (remap[s] < 0) {
+                remap[s] = 0;
+                live.push_back(s);
+            }
+    sort(live.begin(), live.end(), [&slotIds](int a, int b) { return slotIds[a] < slotIds[b]; });
+    g.ids.reserve(live.size());
+    for (int i = 0; i < static_cast<int>(live.size()); ++i) {
+        remap[live[i]] = i;
+        g.ids.push_back(slotIds[live[i]]);
+        g.index[slotIds[live[i]]] = i;
+    }
+
+    // Counting sort by tail, then sort and dedupe each row.
+    int n = g.vertexCount();
+    g.offsets.assign(n + 1, 0);
+    for (const auto& a : arcs) ++g.offsets[remap[a.first] + 1];
+    for (int v = 0; v < n; ++v) g.offsets[v + 1] += g.offsets[v];
+    g.targets.resize(arcs.size());
+    vector<int> fill(g.offsets.begin(), g.offsets.end() - 1);
+    for (const auto& a : arcs) g.targets[fill[remap[a.first]]++] = remap[a.second];
+
+    int write = 0;
+    for (int v = 0; v < n; ++v) {
+        auto first = g.targets.begin() + g.offsets[v], last = g.targets.begin() + g.offsets[v + 1];
+        sort(first, last);
+        last = unique(first, last);
+        g.offsets[v] = write;
+        write = static_cast<int>(copy(first, last, g.targets.begin() + write) - g.targets.begin());
+    }
+    g.offsets[n] = write;
+    g.targets.resize(write);
+    return g;
+}
+
+CsrSubgraph::CsrSubgraph(const CsrGraph& g, const vector<int>& value, int threshold)
+    : g(&g), value(&value), minimum(threshold) {
+    for (int v = 0; v < g.vertexCount(); ++v)
+        if (contains(v)) ++members;
+}
+
+bool CsrSubgraph::containsId(int id) const {
+    if (!g) return false;
+    int v = g->indexOf(id);
+    return v >= 0 && contains(v);
+}
+
+vector<int> CsrSubgraph::vertexIds() const {
+    vector<int> result;
+    if (!g) return result;
+    result.reserve(members);
+    for (int v = 0; v < g->vertexCount(); ++v)
+        if (contains(v)) result.push_back(g->idOf(v));
+    return result;
+}
+
+int CsrSubgraph::degree(int v) const {
+    int d = 0;
+    for (int u : g->neighbors(v))
+        if (contains(u)) ++d;
+    return d;
+}
+
+size_t CsrSubgraph::edgeCount() const {
+    size_t count = 0;
+    if (!g) return count;
+    for (int v = 0; v < g->vertexCount(); ++v)
+        if (contains(v)) count += degree(v);
+    return count;
+}
@@ -0,0 +1,126 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <map>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+using namespace std;
+
+// Immutable compressed-sparse-row snapshot of an adjacency structure.
+// Vertices get dense indices 0..n-1, in the order each factory documents; the
+// neighbors of vertex v are targets[offsets[v] .. offsets[v + 1]), sorted and unique.
+class CsrGraph {
+public:
+    struct NeighborRange {
+        const int* first;
+        const int* last;
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    CsrGraph();
+
+    // Keys take indices in ascending ID order; IDs that appear only as
+    // neighbors follow, in the order they are first met.
+    static CsrGraph fromAdjacency(const map<int, vector<int>>& adjacency);
+    // Every endpoint is a key, so indices follow ascending ID order.
+    static CsrGraph fromEdges(const vector<pair<int, int>>& edges, bool undirected = true);
+    // rows[s] lists neighbor slots of slot s, rowIds[s] is its external ID.
+    // Slots with no neighbors are left out; the rest are indexed by ascending ID.
+    static CsrGraph fromDense(const vector<vector<int>>& rows, const vector<int>& rowIds);
+    // Directed arcs between slots: neighbors(v) are the heads of the arcs
+    // leaving v. Every slot touched by an arc gets a vertex, so unlike
+    // fromDense a vertex may have an empty row. O(n + m), no ID lookups.
+    static CsrGraph fromArcs(const vector<pair<int, int>>& arcs, const vector<int>& slotIds);
+
+    int vertexCount() const { return static_cast<int>(ids.size()); }
+    size_t edgeCount() const { return targets.size(); }
+    bool empty() const { return ids.empty(); }
+
+    int indexOf(int id) const;
+    int idOf(int v) const { return ids[v]; }
+    const vector<int>& vertexIds() const { return ids; }
+    const unordered_map<int, int>& indexMap() const { return index; }
+
+    NeighborRange neighbors(int v) const {
+        return { targets.data() + offsets[v], targets.data() + offsets[v + 1] };
+    }
+    int degree(int v) const { return offsets[v + 1] - offsets[v]; }
+
+    const vector<int>& offsetArray() const { return offsets; }
+    const vector<int>& targetArray() const { return targets; }
+
+    // Optional edge weights, parallel to the target array; an unweighted
+    // graph reports 1 for every edge. Edge e of v is offsets[v] + i.
+    void assignWeights(vector<double> w) { weights = move(w); }
+    bool weighted() const { return !weights.empty(); }
+    double weight(size_t edge) const { return weights.empty() ? 1.0 : weights[edge]; }
+    size_t edgeBegin(int v) const { return static_cast<size_t>(offsets[v]); }
+    const vector<double>& weightArray() const { return weights; }
+
+private:
+    vector<int> offsets;
+    vector<int> targets;
+    vector<double> weights;
+    vector<int> ids;
+    unordered_map<int, int> index;
+};
+
+// Zero-copy view of the vertices v of a CSR with value[v] >= threshold and
+// the edges among them, e.g. a k-core over core numbers. Borrows both the
+// graph and the values; neighbor ranges skip filtered vertices lazily.
+class CsrSubgraph {
+public:
+    class NeighborIterator {
+        const int* pos;
+        const int* last;
+        const CsrSubgraph* view;
+        void skip() { while (pos != last && !view->contains(*pos)) ++pos; }
+    public:
+        NeighborIterator(const int* pos, const int* last, const CsrSubgraph* view)
+            : pos(pos), last(last), view(view) { skip(); }
+        int operator*() const { return *pos; }
+        NeighborIterator& operator++() { ++pos; skip(); return *this; }
+        bool operator!=(const NeighborIterator& o) const { return pos != o.pos; }
+        bool operator==(const NeighborIterator& o) const { return pos == o.pos; }
+    };
+
+    struct NeighborRange {
+        NeighborIterator first;
+        NeighborIterator last;
+        NeighborIterator begin() const { return first; }
+        NeighborIterator end() const { return last; }
+    };
+
+    CsrSubgraph() {}
+    CsrSubgraph(const CsrGraph& g, const vector<int>& value, int threshold);
+
+    const CsrGraph& graph() const { return *g; }
+    int threshold() const { return minimum; }
+    // Dense indices are the full graph's; contains tells which ones are in.
+    bool contains(int v) const { return (*value)[v] >= minimum; }
+    bool containsId(int id) const;
+    int vertexCount() const { return members; }
+    bool empty() const { return members == 0; }
+    // IDs of the kept vertices, ascending.
+    vector<int> vertexIds() const;
+
+    NeighborRange neighbors(int v) const {
+        auto all = g->neighbors(v);
+        return { NeighborIterator(all.first, all.last, this), NeighborIterator(all.last, all.last, this) };
+    }
+    int degree(int v) const;
+    // Directed edge entries, like CsrGraph::edgeCount.
+    size_t edgeCount() const;
+
+private:
+    const CsrGraph* g = nullptr;
+    const vector<int>* value = nullptr;
+    int minimum = 0;
+    int members = 0;
+};
+
+#endif // CSR_GRAPH_H
@@ -0,0 +1,102 @@
+#include "DisjointSets.h"
+#include <utility>
+
+void DisjointSets::resize(int n) {
+    for (int v = size(); v < n; ++v) {
+        parent.push_back(v);
+        setSize.push_back(1);
+        nextMember.push_back(v);
+        stalePosition.push_back(-1);
+        ++sets;
+    }
+}
+
+void DisjointSets::clear() {
+    for (int v = 0; v < size(); ++v) {
+        parent[v] = v;
+        setSize[v] = 1;
+        nextMember[v] = v;
+        stalePosition[v] = -1;
+    }
+    staleRoots.clear();
+    sets = size();
+}
+
+int DisjointSets::find(int v) {
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+bool DisjointSets::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+    if (setSize[a] < setSize[b]) swap(a, b);
+    parent[b] = a;
+    setSize[a] += setSize[b];
+    swap(nextMember[a], nextMember[b]);
+    if (isStale(b)) {
+        clearStale(b);
+        markStale(a);
+    }
+    --sets;
+    return true;
+}
+
+void DisjointSets::invalidate(int v) {
+    int root = find(v);
+    if (setSize[root] == 1) return;
+    markStale(root);
+}
+
+void DisjointSets::refresh(int v, const vector<vector<int>>& adjacency) {
+    int root = find(v);
+    if (isStale(root)) rebuild(root, adjacency);
+}
+
+void DisjointSets::refreshAll(const vector<vector<int>>& adjacency) {
+    // Each rebuild takes its root off the list.
+    while (!staleRoots.empty())
+        rebuild(staleRoots.back(), adjacency);
+}
+
+void DisjointSets::markStale(int root) {
+    if (isStale(root)) return;
+    stalePosition[root] = static_cast<int>(staleRoots.size());
+    staleRoots.push_back(root);
+}
+
+void DisjointSets::clearStale(int v) {
+    int i = stalePosition[v];
+    if (i < 0) return;
+    int last = staleRoots.back();
+    staleRoots[i] = last;
+    stalePosition[last] = i;
+    staleRoots.pop_back();
+    stalePosition[v] = -1;
+}
+
+void DisjointSets::rebuild(int root, const vector<vector<int>>& adjacency) {
+    // Split the set into singletons, then re-unite along the edges that
+    // are left; no edge leaves the old set, so nothing else is touched.
+    scratch.clear();
+    int v = root;
+    do {
+        scratch.push_back(v);
+        v = nextMember[v];
+    } while (v != root);
+
+    for (int m : scratch) {
+        parent[m] = m;
+        setSize[m] = 1;
+        nextMember[m] = m;
+        clearStale(m);
+    }
+    sets += static_cast<int>(scratch.size()) - 1;
+    for (int m : scratch)
+        for (int n : adjacency[m])
+            unite(m, n);
+}
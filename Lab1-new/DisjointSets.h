@@ -0,0 +1,51 @@
+#ifndef DISJOINT_SETS_H
+#define DISJOINT_SETS_H
+
+#include <vector>
+using namespace std;
+
+// Union-find over dense slots with path halving and union by size. Each
+// set also keeps its members on a circular list, so a set invalidated by
+// an edge removal can be rebuilt on its own, lazily, from the adjacency.
+class DisjointSets {
+private:
+    vector<int> parent;
+    vector<int> setSize;
+    vector<int> nextMember;
+    // Roots awaiting a rebuild; stalePosition[v] is v's index in
+    // staleRoots, -1 when v is not stale.
+    vector<int> staleRoots;
+    vector<int> stalePosition;
+    vector<int> scratch;
+    int sets = 0;
+
+    bool isStale(int v) const { return stalePosition[v] >= 0; }
+    void markStale(int root);
+    void clearStale(int v);
+    void rebuild(int root, const vector<vector<int>>& adjacency);
+
+public:
+    // Grows to n slots; new slots start as singletons.
+    void resize(int n);
+    // Every slot back to a singleton.
+    void clear();
+
+    int find(int v);
+    // Merges the sets of a and b; false if they were already one set.
+    bool unite(int a, int b);
+
+    // Marks the set containing v for rebuilding after an edge removal.
+    void invalidate(int v);
+    // Rebuilds v's set if it is stale.
+    void refresh(int v, const vector<vector<int>>& adjacency);
+    // Rebuilds every stale set.
+    void refreshAll(const vector<vector<int>>& adjacency);
+
+    int size() const { return static_cast<int>(parent.size()); }
+    // Number of sets, singletons included.
+    int count() const { return sets; }
+    // Sets waiting for a rebuild.
+    int staleCount() const { return static_cast<int>(staleRoots.size()); }
+};
+
+#endif // DISJOINT_SETS_H
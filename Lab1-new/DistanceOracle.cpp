@@ -0,0 +1,68 @@
+#include "DistanceOracle.h"
+#include "GraphAlgorithms.h"
+#include <algorithm>
+#include <cstdlib>
+
+DistanceOracle DistanceOracle::build(const CsrGraph& g, int landmarks, unsigned long long epoch, int threads) {
+    DistanceOracle oracle;
+    oracle.builtEpoch = epoch;
+    oracle.index = g.indexMap();
+    int n = g.vertexCount();
+    int k = min(max(landmarks, 0), n);
+    if (k == 0) return oracle;
+
+    // Highest degree first; ties go to the lower index so builds are repeatable.
+    vector<int> order(n);
+    for (int v = 0; v < n; ++v) order[v] = v;
+    partial_sort(order.begin(), order.begin() + k, order.end(), [&g](int a, int b) {
+        return g.degree(a) != g.degree(b) ? g.degree(a) > g.degree(b) : a < b;
+        });
+    for (int i = 0; i < k; ++i)
+        oracle.landmarkIds.push_back(g.idOf(order[i]));
+
+    SearchWorkspace ws;
+    auto batch = GraphAlgorithms::multiSourceBfs(g, oracle.landmarkIds, ws, threads);
+    oracle.landmarkCount = k;
+    oracle.distances.resize(static_cast<size_t>(n) * k);
+    for (int i = 0; i < k; ++i) {
+        const auto& row = batch.row(i);
+        for (int v = 0; v < n; ++v)
+            oracle.distances[static_cast<size_t>(v) * k + i] = row[v];
+    }
+    return oracle;
+}
+
+DistanceEstimate DistanceOracle::estimate(int a, int b) const {
+    DistanceEstimate result;
+    auto ia = index.find(a), ib = index.find(b);
+    // Vertices outside the snapshot have no edges: they reach nobody.
+    if (ia == index.end() || ib == index.end()) {
+        result.lower = -1;
+        result.exact = true;
+        return result;
+    }
+    if (a == b) {
+        result.upper = 0;
+        result.exact = true;
+        return result;
+    }
+
+    const int* da = distances.data() + static_cast<size_t>(ia->second) * landmarkCount;
+    const int* db = distances.data() + static_cast<size_t>(ib->second) * landmarkCount;
+    for (int i = 0; i < landmarkCount; ++i) {
+        if (da[i] < 0 && db[i] < 0) continue;
+        // A landmark that reaches only one of them separates the components.
+        if (da[i] < 0 || db[i] < 0) {
+            result.lower = result.upper = -1;
+            result.exact = true;
+            return result;
+        }
+        result.lower = max(result.lower, abs(da[i] - db[i]));
+        int through = da[i] + db[i];
+        if (result.upper < 0 || through < result.upper) result.upper = through;
+    }
+    // Distinct vertices are at least one hop apart.
+    result.lower = max(result.lower, 1);
+    result.exact = result.upper >= 0 && result.lower == result.upper;
+    return result;
+}
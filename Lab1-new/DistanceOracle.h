@@ -0,0 +1,39 @@
+#ifndef DISTANCE_ORACLE_H
+#define DISTANCE_ORACLE_H
+
+#include <vector>
+#include <unordered_map>
+#include "CsrGraph.h"
+using namespace std;
+
+// Bounds on a hop distance. upper is -1 when no landmark reaches both
+// ends; an exact answer of -1 means the two are not connected.
+struct DistanceEstimate {
+    int lower = 0;
+    int upper = -1;
+    bool exact = false;
+};
+
+// Landmark distance oracle: BFS distances from the k highest-degree
+// vertices of a snapshot. For a landmark L, |d(a,L) - d(L,b)| and
+// d(a,L) + d(L,b) bound d(a,b), so a query costs O(k).
+class DistanceOracle {
+private:
+    int landmarkCount = 0;
+    // distances[v * landmarkCount + i]: vertex v to landmark i, -1 if unreachable.
+    vector<int> distances;
+    vector<int> landmarkIds;
+    unordered_map<int, int> index;
+    unsigned long long builtEpoch = 0;
+
+public:
+    DistanceOracle() {}
+    static DistanceOracle build(const CsrGraph& g, int landmarks, unsigned long long epoch, int threads = 0);
+
+    DistanceEstimate estimate(int a, int b) const;
+
+    const vector<int>& landmarks() const { return landmarkIds; }
+    unsigned long long epoch() const { return builtEpoch; }
+};
+
+#endif // DISTANCE_ORACLE_H
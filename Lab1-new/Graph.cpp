@@ -4,89 +4,237 @@
 #include "User.h" 
 #include <vector>
 #include <fstream>
-#include <map>
 #include <string>
 #include <iostream>
 using namespace std;
 
 Graph::~Graph() {
-    for (auto& p : vertices) delete p.second;
-    for (auto* e : edges) delete e;
+    // Pooled objects only need their destructors run: the slabs themselves
+    // are released all at once when the pools go away.
+    for (auto* v : slotVertex) {
+        if (v->ownerPool) v->~Vertex();
+        else delete v;
+    }
+    forEachEdge([](Edge* e) {
+        if (e->ownerPool) e->~Edge();
+        else delete e;
+        });
+}
+
+void Graph::destroyVertex(Vertex* v) {
+    if (SlabPool* pool = v->ownerPool) {
+        v->~Vertex();
+        pool->release(v);
+    }
+    else {
+        delete v;
+    }
+}
+
+void Graph::destroyEdge(Edge* e) {
+    if (SlabPool* pool = e->ownerPool) {
+        e->~Edge();
+        pool->release(e);
+    }
+    else {
+        delete e;
+    }
 }
 
-void Graph::addVertex(Vertex* v) {
+bool Graph::addVertex(Vertex* v) {
     if (!v) {
         LOG_WARN("Attempted to add null vertex");
-        return;
+        return false;
+    }
+    if (slotOf.count(v->getId())) {
+        LOG_WARN("Vertex ID=" + to_string(v->getId()) + " already exists");
+        destroyVertex(v);
+        return false;
     }
-    vertices[v->getId()] = v;
+    slotOf[v->getId()] = static_cast<int>(slotVertex.size());
+    slotVertex.push_back(v);
+    slotOut.emplace_back();
+    slotIn.emplace_back();
     LOG_INFO("Added vertex ID=" + to_string(v->getId()));
+    return true;
 }
 
-void Graph::addEdge(Edge* e) {
+bool Graph::addEdge(Edge* e) {
     if (!e) {
         LOG_WARN("Attempted to add null edge");
-        return;
+        return false;
+    }
+    int from = vertexSlot(e->getFrom());
+    int to = e->getTo() == Edge::NoTarget ? -1 : vertexSlot(e->getTo());
+    if (from < 0 || (to < 0 && e->getTo() != Edge::NoTarget)) {
+        LOG_WARN("Rejected edge from " + to_string(e->getFrom()) + " to " + to_string(e->getTo()) +
+            ": endpoint does not exist");
+        destroyEdge(e);
+        return false;
+    }
+
+    auto& bucket = edgesOfKind(e->getKind());
+    e->slot = bucket.size();
+    bucket.push_back(e);
+    auto& list = edgeIndex[EdgeKey{ e->getFrom(), e->getTo(), e->getKind() }];
+    e->indexSlot = list.size();
+    list.push_back(e);
+    e->outSlot = slotOut[from].size();
+    slotOut[from].push_back(e);
+    if (to >= 0) {
+        e->inSlot = slotIn[to].size();
+        slotIn[to].push_back(e);
     }
-    edges.push_back(e);
     LOG_DEBUG("Added edge from " + to_string(e->getFrom()) + " to " + to_string(e->getTo()));
+    return true;
+}
+
+int Graph::vertexSlot(int id) const {
+    auto it = slotOf.find(id);
+    return it != slotOf.end() ? it->second : -1;
+}
+
+const vector<Edge*>& Graph::outEdgesOf(int id) const {
+    static const vector<Edge*> none;
+    int slot = vertexSlot(id);
+    return slot >= 0 ? slotOut[slot] : none;
+}
+
+const vector<Edge*>& Graph::inEdgesOf(int id) const {
+    static const vector<Edge*> none;
+    int slot = vertexSlot(id);
+    return slot >= 0 ? slotIn[slot] : none;
+}
+
+void Graph::swapOut(vector<Edge*>& list, Edge* e, size_t Edge::* position) {
+    Edge* last = list.back();
+    list[e->*position] = last;
+    last->*position = e->*position;
+    list.pop_back();
+}
+
+void Graph::unlinkEdge(Edge* e, int dyingSlot) {
+    int from = vertexSlot(e->getFrom());
+    if (from >= 0 && from != dyingSlot) swapOut(slotOut[from], e, &Edge::outSlot);
+    int to = e->getTo() == Edge::NoTarget ? -1 : vertexSlot(e->getTo());
+    if (to >= 0 && to != dyingSlot) swapOut(slotIn[to], e, &Edge::inSlot);
+}
+
+void Graph::detachEdge(Edge* e, int dyingSlot) {
+    // Swap-and-pop out of the kind bucket, the index and the endpoint lists.
+    swapOut(edgesOfKind(e->getKind()), e, &Edge::slot);
+
+    auto it = edgeIndex.find(EdgeKey{ e->getFrom(), e->getTo(), e->getKind() });
+    if (it != edgeIndex.end()) {
+        swapOut(it->second, e, &Edge::indexSlot);
+        if (it->second.empty()) edgeIndex.erase(it);
+    }
+    unlinkEdge(e, dyingSlot);
+}
+
+void Graph::collectEdges(int from, int to, EdgeKind kind, vector<Edge*>& out) const {
+    auto it = edgeIndex.find(EdgeKey{ from, to, kind });
+    if (it != edgeIndex.end())
+        out.insert(out.end(), it->second.begin(), it->second.end());
+}
+
+size_t Graph::countEdges(int from, int to, EdgeKind kind) const {
+    auto it = edgeIndex.find(EdgeKey{ from, to, kind });
+    return it != edgeIndex.end() ? it->second.size() : 0;
+}
+
+bool Graph::hasEdge(int from, int to, EdgeKind kind) const {
+    return edgeIndex.count(EdgeKey{ from, to, kind }) > 0;
 }
 
 void Graph::removeVertex(int id) {
     LOG_DEBUG("Attempting to remove vertex ID=" + to_string(id));
-    if (vertices.count(id)) {
-        auto it = remove_if(edges.begin(), edges.end(), [id](Edge* e) {
-            if (e->getFrom() == id || e->getTo() == id) {
-                delete e;
-                return true;
-            }
-            return false;
-            });
-        auto removedEdges = edges.end() - it;;
-        edges.erase(it, edges.end());
-
-        delete vertices[id];
-        vertices.erase(id);
-
-        LOG_INFO("Removed vertex ID=" + to_string(id) + " and " + to_string(removedEdges) + " related edges");
-    }
-    else {
+    int slot = vertexSlot(id);
+    if (slot < 0) {
         LOG_WARN("Attempted to remove non-existent vertex ID=" + to_string(id));
+        return;
+    }
+
+    // The vertex's own lists stay untouched while its edges go, so they
+    // can be walked in place. Self-loops sit in both lists: the incoming
+    // pass skips them while they are still alive, the outgoing one frees them.
+    size_t removedEdges = 0;
+    for (auto* e : slotIn[slot]) {
+        if (e->getFrom() == id) continue;
+        detachEdge(e, slot);
+        destroyEdge(e);
+        ++removedEdges;
+    }
+    for (auto* e : slotOut[slot]) {
+        detachEdge(e, slot);
+        destroyEdge(e);
+        ++removedEdges;
+    }
+
+    destroyVertex(slotVertex[slot]);
+    int last = static_cast<int>(slotVertex.size()) - 1;
+    if (slot != last) {
+        slotVertex[slot] = slotVertex[last];
+        slotOut[slot] = move(slotOut[last]);
+        slotIn[slot] = move(slotIn[last]);
+        slotOf[slotVertex[slot]->getId()] = slot;
     }
+    slotVertex.pop_back();
+    slotOut.pop_back();
+    slotIn.pop_back();
+    slotOf.erase(id);
+
+    LOG_INFO("Removed vertex ID=" + to_string(id) + " and " + to_string(removedEdges) + " related edges");
 }
 
 void Graph::removeEdge(int from, int to) {
     LOG_DEBUG("Attempting to remove edge from " + to_string(from) + " to " + to_string(to));
 
-    auto removeEdgeLambda = [](vector<Edge*>& edges, int f, int t) {
-        auto it = remove_if(edges.begin(), edges.end(), [f, t](Edge* e) {
-            if (e->getFrom() == f && e->getTo() == t) {
-                delete e;
-                return true;
-            }
-            return false;
-            });
-        if (it != edges.end()) {
-            edges.erase(it, edges.end());
-            return true;
-        }
-        return false;
-        };
-
-    bool removed1 = removeEdgeLambda(edges, from, to);
-    bool removed2 = removeEdgeLambda(edges, to, from); 
+    vector<Edge*> matched;
+    for (int k = 0; k < EdgeKindCount; ++k) {
+        collectEdges(from, to, static_cast<EdgeKind>(k), matched);
+        if (from != to) collectEdges(to, from, static_cast<EdgeKind>(k), matched);
+    }
 
-    if (removed1 || removed2)
-        LOG_INFO("Removed edge between " + to_string(from) + " and " + to_string(to));
-    else
+    if (matched.empty()) {
         LOG_WARN("No edge found between " + to_string(from) + " and " + to_string(to));
+        return;
+    }
+
+    for (auto* e : matched) {
+        detachEdge(e);
+        destroyEdge(e);
+    }
+
+    LOG_INFO("Removed edge between " + to_string(from) + " and " + to_string(to));
+}
+
+void Graph::removeEdge(int from, int to, EdgeKind kind) {
+    LOG_DEBUG("Attempting to remove edges of kind " + to_string(static_cast<int>(kind)) +
+        " between " + to_string(from) + " and " + to_string(to));
+
+    vector<Edge*> matched;
+    collectEdges(from, to, kind, matched);
+    if (from != to) collectEdges(to, from, kind, matched);
+
+    if (matched.empty()) {
+        LOG_WARN("No edge of this kind between " + to_string(from) + " and " + to_string(to));
+        return;
+    }
+
+    for (auto* e : matched) {
+        detachEdge(e);
+        destroyEdge(e);
+    }
+
+    LOG_INFO("Removed " + to_string(matched.size()) + " edges between " + to_string(from) + " and " + to_string(to));
 }
 
 Vertex* Graph::getVertex(int id) const {
-    auto it = vertices.find(id);
-    if (it != vertices.end()) {
+    int slot = vertexSlot(id);
+    if (slot >= 0) {
         LOG_DEBUG("Vertex found ID=" + to_string(id));
-        return it->second;
+        return slotVertex[slot];
     }
     else {
         LOG_DEBUG("Vertex not found ID=" + to_string(id));
@@ -96,31 +244,56 @@ Vertex* Graph::getVertex(int id) const {
 
 vector<int> Graph::getNeighbors(int id) const {
     vector<int> neighbors;
-    for (auto* e : edges) {
-        if (e->getFrom() == id) neighbors.push_back(e->getTo());
-    }
+    const auto& out = outEdgesOf(id);
+    neighbors.reserve(out.size());
+    for (auto* e : out) neighbors.push_back(e->getTo());
     LOG_DEBUG("Found " + to_string(neighbors.size()) + " neighbors for vertex ID=" + to_string(id));
     return neighbors;
 }
 
+vector<int> Graph::getInNeighbors(int id) const {
+    vector<int> neighbors;
+    const auto& in = inEdgesOf(id);
+    neighbors.reserve(in.size());
+    for (auto* e : in) neighbors.push_back(e->getFrom());
+    LOG_DEBUG("Found " + to_string(neighbors.size()) + " incoming neighbors for vertex ID=" + to_string(id));
+    return neighbors;
+}
+
+size_t Graph::outDegree(int id) const {
+    return outEdgesOf(id).size();
+}
+
+size_t Graph::inDegree(int id) const {
+    return inEdgesOf(id).size();
+}
+
 vector<Vertex*> Graph::getAllVertices() const {
-    LOG_DEBUG("Retrieving all vertices (" + to_string(vertices.size()) + ")");
-    vector<Vertex*> result;
-    for (auto& p : vertices) result.push_back(p.second);
-    return result;
+    LOG_DEBUG("Retrieving all vertices (" + to_string(slotVertex.size()) + ")");
+    return slotVertex;
 }
 
 vector<Edge*> Graph::getAllEdges() const {
-    LOG_DEBUG("Retrieving all edges (" + to_string(edges.size()) + ")");
-    return edges;
+    LOG_DEBUG("Retrieving all edges (" + to_string(edgeCount()) + ")");
+    vector<Edge*> result;
+    result.reserve(edgeCount());
+    for (const auto& bucket : edges)
+        result.insert(result.end(), bucket.begin(), bucket.end());
+    return result;
+}
+
+size_t Graph::edgeCount() const {
+    size_t total = 0;
+    for (const auto& bucket : edges) total += bucket.size();
+    return total;
 }
 
 void Graph::print() const {
     LOG_DEBUG("Printing graph structure");
     cout << "Vertices" << endl;
-    for (auto& p : vertices) p.second->print();
+    for (auto* v : slotVertex) v->print();
     cout << "Edges" << endl;
-    for (auto* e : edges) e->print();
+    forEachEdge([](Edge* e) { e->print(); });
 }
 
 void Graph::exportToDotGraph(const string& filename) const {
@@ -134,32 +307,22 @@ void Graph::exportToDotGraph(const string& filename) const {
     file << "digraph G {\n";
     file << "  rankdir=LR;\n";
 
-    for (const auto& p : vertices) {
-        int id = p.first;
+    for (auto* v : slotVertex) {
+        int id = v->getId();
         file << "  " << id << " [label=\"User id " << id << "\"];\n";
     }
 
-    for (auto* e : edges) {
-        if (dynamic_cast<const Friendship*>(e)) {
-            file << "  " << e->getFrom() << " -> " << e->getTo()
-                << " [color=blue, label=\"friend\"];\n";
+    forEachEdge([&file](Edge* e) {
+        file << "  " << e->getFrom() << " -> " << e->getTo();
+        switch (e->getKind()) {
+        case EdgeKind::Friendship:   file << " [color=blue, label=\"friend\"]"; break;
+        case EdgeKind::Subscription: file << " [color=green, label=\"follow\"]"; break;
+        case EdgeKind::Message:      file << " [color=red, label=\"msg\"]"; break;
+        case EdgeKind::Post:         file << " [color=yellow, label=\"post\"]"; break;
+        default: break;
         }
-        else if (dynamic_cast<const Subscription*>(e)) {
-            file << "  " << e->getFrom() << " -> " << e->getTo()
-                << " [color=green, label=\"follow\"];\n";
-        }
-        else if (dynamic_cast<const Message*>(e)) {
-            file << "  " << e->getFrom() << " -> " << e->getTo()
-                << " [color=red, label=\"msg\"];\n";
-        }
-        else if (dynamic_cast<const Post*>(e)) {
-            file << "  " << e->getFrom() << " -> " << e->getTo()
-                << " [color=yellow, label=\"post\"];\n";
-        }
-        else {
-            file << "  " << e->getFrom() << " -> " << e->getTo() << ";\n";
-        }
-    }
+        file << ";\n";
+        });
 
     file << "}\n";
     file.close();
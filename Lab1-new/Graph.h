@@ -6,6 +6,13 @@
 #include <algorithm>
 #include <string>
 #include <iostream>
+#include <memory>
+#include <new>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include "SlabPool.h"
 using namespace std;
 
 template <typename Derived>
@@ -22,6 +29,8 @@ public:
 };
 
 class Vertex {
+    friend class Graph;
+    SlabPool* ownerPool = nullptr;
 protected:
     int id;
 public:
@@ -31,67 +40,180 @@ public:
     virtual void print() const = 0;
 };
 
+// Compact relationship tag, so type filters need no RTTI.
+enum class EdgeKind {
+    Generic,
+    Friendship,
+    Subscription,
+    Message,
+    Post
+};
+
+const int EdgeKindCount = 5;
+
 class Edge {
+    friend class Graph;
+    SlabPool* ownerPool = nullptr;
+    // Positions in the kind bucket, the edgeIndex list, and the out/in
+    // lists of the endpoints, so removal can swap-and-pop from each.
+    size_t slot = 0;
+    size_t indexSlot = 0;
+    size_t outSlot = 0;
+    size_t inSlot = 0;
 protected:
     int from;
     int to;
+    EdgeKind kind;
 public:
-    Edge(int f, int t) : from(f), to(t) {}
+    static constexpr EdgeKind Kind = EdgeKind::Generic;
+    // Target of edges that do not point at a vertex (posts).
+    static constexpr int NoTarget = -1;
+
+    Edge(int f, int t, EdgeKind k = EdgeKind::Generic) : from(f), to(t), kind(k) {}
     virtual ~Edge() {}
     int getFrom() const { return from; }
     int getTo() const { return to; }
+    EdgeKind getKind() const { return kind; }
     virtual void print() const = 0;
 };
 
+struct EdgeKey {
+    int from;
+    int to;
+    EdgeKind kind;
+    bool operator==(const EdgeKey& o) const { return from == o.from && to == o.to && kind == o.kind; }
+};
+
+struct EdgeKeyHash {
+    size_t operator()(const EdgeKey& k) const {
+        unsigned long long h = static_cast<unsigned int>(k.from);
+        h = h * 0x9E3779B97F4A7C15ULL ^ static_cast<unsigned int>(k.to);
+        h = h * 0x9E3779B97F4A7C15ULL ^ static_cast<unsigned int>(k.kind);
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+};
+
 
 class Graph {
 protected:
-    map<int, Vertex*> vertices;
-    vector<Edge*> edges;
+    // External vertex IDs map to dense slots; per-vertex data lives in flat
+    // arrays indexed by slot. Removal swap-and-pops the last vertex into the hole.
+    unordered_map<int, int> slotOf;
+    vector<Vertex*> slotVertex;
+    vector<vector<Edge*>> slotOut;
+    vector<vector<Edge*>> slotIn;
+
+    vector<Edge*> edges[EdgeKindCount];
+    unordered_map<EdgeKey, vector<Edge*>, EdgeKeyHash> edgeIndex;
+
+    // One slab pool per concrete vertex/edge type created through emplace*.
+    unordered_map<type_index, unique_ptr<SlabPool>> pools;
+
+    vector<Edge*>& edgesOfKind(EdgeKind kind) { return edges[static_cast<int>(kind)]; }
+    const vector<Edge*>& outEdgesOf(int id) const;
+    const vector<Edge*>& inEdgesOf(int id) const;
+    // dyingSlot's own lists are left alone: removeVertex drops them whole.
+    void unlinkEdge(Edge* e, int dyingSlot = -1);
+    void detachEdge(Edge* e, int dyingSlot = -1);
+    static void swapOut(vector<Edge*>& list, Edge* e, size_t Edge::* position);
+    void collectEdges(int from, int to, EdgeKind kind, vector<Edge*>& out) const;
+    void destroyVertex(Vertex* v);
+    void destroyEdge(Edge* e);
+
+    template <typename T>
+    SlabPool& poolFor() {
+        auto& pool = pools[type_index(typeid(T))];
+        if (!pool) pool.reset(new SlabPool(sizeof(T)));
+        return *pool;
+    }
 
 public:
     virtual ~Graph();
 
-    virtual void addVertex(Vertex* v);
-    virtual void addEdge(Edge* e);
+    // Both take ownership; a rejected object is destroyed and false returned.
+    virtual bool addVertex(Vertex* v);
+    virtual bool addEdge(Edge* e);
     virtual void removeVertex(int id);
     virtual void removeEdge(int from, int to);
+    // Removes only edges of the given kind, in both directions.
+    virtual void removeEdge(int from, int to, EdgeKind kind);
+    bool hasEdge(int from, int to, EdgeKind kind) const;
+
+    // Construct a vertex/edge in the graph's slab pool and add it; the graph
+    // owns the object and frees the pools in bulk on destruction.
+    template <typename T, typename... Args>
+    T* emplaceVertex(Args&&... args) {
+        SlabPool& pool = poolFor<T>();
+        T* v = new (pool.allocate()) T(std::forward<Args>(args)...);
+        v->ownerPool = &pool;
+        return addVertex(v) ? v : nullptr;
+    }
+
+    template <typename T, typename... Args>
+    T* emplaceEdge(Args&&... args) {
+        SlabPool& pool = poolFor<T>();
+        T* e = new (pool.allocate()) T(std::forward<Args>(args)...);
+        e->ownerPool = &pool;
+        return addEdge(e) ? e : nullptr;
+    }
 
     virtual Vertex* getVertex(int id) const;
+    int vertexSlot(int id) const;
+    int vertexIdAt(int slot) const { return slotVertex[slot]->getId(); }
+    size_t vertexCount() const { return slotVertex.size(); }
     virtual vector<int> getNeighbors(int id) const;
+    virtual vector<int> getInNeighbors(int id) const;
+    size_t outDegree(int id) const;
+    size_t inDegree(int id) const;
     virtual vector<Vertex*> getAllVertices() const;
     virtual vector<Edge*> getAllEdges() const;
+    const vector<Edge*>& getEdgesOfKind(EdgeKind kind) const { return edges[static_cast<int>(kind)]; }
+    size_t countEdges(EdgeKind kind) const { return getEdgesOfKind(kind).size(); }
+    // Parallel edges of one kind directed from -> to.
+    size_t countEdges(int from, int to, EdgeKind kind) const;
+    size_t edgeCount() const;
 
     virtual void print() const;
     virtual void exportToDotGraph(const string& filename) const;
 
     template <typename Func>
     void forEachVertex(Func f) const {
-        for (auto& p : vertices)
-            f(p.second);
+        for (auto* v : slotVertex)
+            f(v);
     }
 
     template <typename Func>
     void forEachEdge(Func f) const {
-        for (auto* e : edges)
-            f(e);
+        for (const auto& bucket : edges)
+            for (auto* e : bucket)
+                f(e);
     }
 
     template <typename T>
     vector<T*> getVerticesOfType() const {
         vector<T*> result;
-        for (auto& p : vertices)
-            if (auto* t = dynamic_cast<T*>(p.second))
+        for (auto* v : slotVertex)
+            if (auto* t = dynamic_cast<T*>(v))
                 result.push_back(t);
         return result;
     }
 
+    // Edge classes with their own Kind are served straight from their bucket;
+    // anything else falls back to a dynamic_cast scan.
     template <typename T>
     vector<T*> getEdgesOfType() const {
         vector<T*> result;
-        for (auto* e : edges)
+        if (T::Kind != EdgeKind::Generic) {
+            const auto& bucket = getEdgesOfKind(T::Kind);
+            result.reserve(bucket.size());
+            for (auto* e : bucket)
+                result.push_back(static_cast<T*>(e));
+            return result;
+        }
+        forEachEdge([&result](Edge* e) {
             if (auto* t = dynamic_cast<T*>(e))
                 result.push_back(t);
+            });
         return result;
     }
 
@@ -101,27 +223,39 @@ public:
             if (item) item->print();
     }
 
+    template <typename T>
+    int countType() const {
+        if (T::Kind != EdgeKind::Generic)
+            return static_cast<int>(countEdges(T::Kind));
+        return static_cast<int>(getEdgesOfType<T>().size());
+    }
+
     template <typename T>
     int countType(const vector<Edge*>& allEdges) const {
         int count = 0;
-        for (auto* e : allEdges)
-            if (dynamic_cast<T*>(e)) ++count;
+        for (auto* e : allEdges) {
+            if (!e) continue;
+            if (T::Kind != EdgeKind::Generic ? e->getKind() == T::Kind : dynamic_cast<T*>(e) != nullptr)
+                ++count;
+        }
         return count;
     }
 
     template <typename T>
     void removeConnectionType(const vector<Edge*>& allEdges, int from, int to) {
-        vector<Edge*> toRemove;
+        if (T::Kind != EdgeKind::Generic) {
+            removeEdge(from, to, T::Kind);
+            return;
+        }
+        bool kinds[EdgeKindCount] = {};
         for (auto* e : allEdges) {
-            if (!e) continue;
-            if (auto* t = dynamic_cast<T*>(e)) {
-                if ((t->getFrom() == from && t->getTo() == to) ||
-                    (t->getFrom() == to && t->getTo() == from))
-                    toRemove.push_back(e);
-            }
+            if (!dynamic_cast<T*>(e)) continue;
+            if ((e->getFrom() == from && e->getTo() == to) ||
+                (e->getFrom() == to && e->getTo() == from))
+                kinds[static_cast<int>(e->getKind())] = true;
         }
-        for (auto* e : toRemove)
-            removeEdge(e->getFrom(), e->getTo());
+        for (int k = 0; k < EdgeKindCount; ++k)
+            if (kinds[k]) removeEdge(from, to, static_cast<EdgeKind>(k));
     }
 };
 
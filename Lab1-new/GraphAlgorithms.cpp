@@ -3,127 +3,1409 @@
 #include <limits>
 #include <set> 
 #include <functional>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <cmath>
+#include <random>
+#include <mutex>
+#include "Parallel.h"
+#include "SetIntersection.h"
 
 GraphAlgorithms::GraphAlgorithms() {}
 
-void GraphAlgorithms::buildGraph(const vector<pair<int, int>>& edges) {
-    adjacencyList.clear();
-    for (const auto& e : edges) {
-        adjacencyList[e.first].push_back(e.second);
-        adjacencyList[e.second].push_back(e.first);
+static long long pairKey(int a, int b) {
+    if (a > b) swap(a, b);
+    return static_cast<long long>((static_cast<unsigned long long>(static_cast<unsigned int>(a)) << 32) |
+        static_cast<unsigned int>(b));
+}
+
+static void insertSorted(vector<int>& list, int value) {
+    auto it = lower_bound(list.begin(), list.end(), value);
+    if (it == list.end() || *it != value) list.insert(it, value);
+}
+
+static void eraseSorted(vector<int>& list, int value) {
+    auto pos = lower_bound(list.begin(), list.end(), value);
+    if (pos != list.end() && *pos == value) list.erase(pos);
+}
+
+int GraphAlgorithms::findSlot(int id) const {
+    auto it = layerSlotOf.find(id);
+    return it != layerSlotOf.end() ? it->second : -1;
+}
+
+int GraphAlgorithms::slotFor(int id) {
+    int slot = findSlot(id);
+    if (slot >= 0) return slot;
+    if (!freeLayerSlots.empty()) {
+        slot = freeLayerSlots.back();
+        freeLayerSlots.pop_back();
+        layerSlotId[slot] = id;
+        // A freed slot may still sit in a stale component; settle it so it
+        // comes back as a singleton.
+        for (auto& data : layers)
+            data.components.refresh(slot, data.adjacency);
+    }
+    else {
+        slot = slotCount();
+        layerSlotId.push_back(id);
+        for (auto& data : layers) {
+            data.adjacency.emplace_back();
+            data.components.resize(slotCount());
+        }
+    }
+    layerSlotOf[id] = slot;
+    return slot;
+}
+
+void GraphAlgorithms::linkSlots(AdjacencyLayer& data, int sa, int sb) {
+    if (data.adjacency[sa].empty()) ++data.presentVertices;
+    insertSorted(data.adjacency[sa], sb);
+    if (data.adjacency[sb].empty()) ++data.presentVertices;
+    insertSorted(data.adjacency[sb], sa);
+    data.components.unite(sa, sb);
+    ++data.epoch;
+    ++data.revision;
+}
+
+void GraphAlgorithms::unlinkSlots(AdjacencyLayer& data, int sa, int sb) {
+    data.components.invalidate(sa);
+    eraseSorted(data.adjacency[sa], sb);
+    if (data.adjacency[sa].empty()) --data.presentVertices;
+    if (sb != sa) {
+        eraseSorted(data.adjacency[sb], sa);
+        if (data.adjacency[sb].empty()) --data.presentVertices;
+    }
+    ++data.epoch;
+    ++data.revision;
+}
+
+void GraphAlgorithms::buildGraph(const vector<pair<int, int>>& edges, Layer layer) {
+    auto& data = layerData(layer);
+    for (auto& list : data.adjacency) list.clear();
+    data.multiplicity.clear();
+    data.components.clear();
+    data.presentVertices = 0;
+    for (const auto& e : edges)
+        addToLayer(data, e.first, e.second);
+    ++data.epoch;
+    ++data.revision;
+    ++epoch;
+}
+
+void GraphAlgorithms::addToLayer(AdjacencyLayer& data, int a, int b) {
+    ++data.revision;
+    if (data.multiplicity[pairKey(a, b)]++ > 0) return;
+    linkSlots(data, slotFor(a), slotFor(b));
+}
+
+void GraphAlgorithms::addAdjacency(int a, int b, Layer layer) {
+    addToLayer(layerData(layer), a, b);
+    if (layer != Layer::All)
+        addToLayer(layerData(Layer::All), a, b);
+    ++epoch;
+}
+
+void GraphAlgorithms::removeAdjacency(int a, int b) {
+    int sa = findSlot(a), sb = findSlot(b);
+    if (sa < 0 || sb < 0) return;
+    bool changed = false;
+    for (auto& data : layers) {
+        if (!data.multiplicity.erase(pairKey(a, b))) continue;
+        unlinkSlots(data, sa, sb);
+        changed = true;
+    }
+    if (changed) ++epoch;
+}
+
+void GraphAlgorithms::removeAdjacency(int a, int b, Layer layer) {
+    if (layer == Layer::All) {
+        removeAdjacency(a, b);
+        return;
+    }
+    int sa = findSlot(a), sb = findSlot(b);
+    if (sa < 0 || sb < 0) return;
+    auto& data = layerData(layer);
+    auto it = data.multiplicity.find(pairKey(a, b));
+    if (it == data.multiplicity.end()) return;
+    int count = it->second;
+    data.multiplicity.erase(it);
+    unlinkSlots(data, sa, sb);
+
+    // The All layer counts this layer's edges too; drop the pair there only
+    // when no other layer still connects it.
+    lowerAllLayer(a, b, sa, sb, count);
+    ++epoch;
+}
+
+void GraphAlgorithms::removeGenericAdjacency(int a, int b, int count) {
+    int sa = findSlot(a), sb = findSlot(b);
+    if (sa < 0 || sb < 0 || count <= 0) return;
+    lowerAllLayer(a, b, sa, sb, count);
+    ++epoch;
+}
+
+void GraphAlgorithms::lowerAllLayer(int a, int b, int sa, int sb, int count) {
+    auto& all = layerData(Layer::All);
+    auto allIt = all.multiplicity.find(pairKey(a, b));
+    if (allIt == all.multiplicity.end()) return;
+    ++all.revision;
+    if ((allIt->second -= count) <= 0) {
+        all.multiplicity.erase(allIt);
+        unlinkSlots(all, sa, sb);
     }
-    for (auto& kv : adjacencyList) {
-        sort(kv.second.begin(), kv.second.end());
+}
+
+void GraphAlgorithms::removeAdjacencyVertex(int id) {
+    int slot = findSlot(id);
+    if (slot < 0) return;
+    for (auto& data : layers) {
+        auto& list = data.adjacency[slot];
+        if (list.empty()) continue;
+        data.components.invalidate(slot);
+        for (int n : list) {
+            data.multiplicity.erase(pairKey(id, layerSlotId[n]));
+            if (n == slot) continue;
+            eraseSorted(data.adjacency[n], slot);
+            if (data.adjacency[n].empty()) --data.presentVertices;
+        }
+        list.clear();
+        --data.presentVertices;
+        ++data.epoch;
+        ++data.revision;
     }
+    layerSlotOf.erase(id);
+    freeLayerSlots.push_back(slot);
+    ++epoch;
+}
+
+bool GraphAlgorithms::inSameComponent(int a, int b, Layer layer) {
+    auto& data = layerData(layer);
+    int sa = findSlot(a), sb = findSlot(b);
+    if (sa < 0 || sb < 0 || data.adjacency[sa].empty() || data.adjacency[sb].empty()) return false;
+    data.components.refresh(sa, data.adjacency);
+    data.components.refresh(sb, data.adjacency);
+    return data.components.find(sa) == data.components.find(sb);
 }
 
-map<int, int> GraphAlgorithms::breadthFirstSearch(int start) {
-    map<int, int> dist;
-    if (!adjacencyList.count(start)) return dist;
+int GraphAlgorithms::componentCount(Layer layer) {
+    auto& data = layerData(layer);
+    data.components.refreshAll(data.adjacency);
+    // Slots without edges are singleton sets that do not count.
+    return data.components.count() - (slotCount() - data.presentVertices);
+}
+
+// Direction-optimizing BFS (Beamer et al.): expand top-down while the
+// frontier is small, switch to bottom-up (unvisited vertices look for a
+// parent in the frontier) once the frontier's edges outweigh the rest.
+// Frontiers are bitmaps; each level is split across threads by words.
+static const size_t TopDownAlpha = 14;
+static const size_t BottomUpBeta = 24;
+static const size_t WordsPerChunk = 64;
+
+template <typename RowOf>
+static void frontierSearch(int n, size_t edgeTotal, int source, RowOf rowOf, SearchWorkspace& ws, int threads) {
+    auto& dist = ws.distance;
+    auto& frontier = ws.frontier;
+    auto& next = ws.next;
+    auto& visited = ws.visited;
+    frontier.assign(n);
+    next.assign(n);
+    visited.assign(n);
+    size_t words = visited.words();
+
+    dist.set(source, 0);
+    frontier.claim(source);
+    visited.claim(source);
+    ws.order.push_back(source);
 
-    queue<int> q;
-    q.push(start);
-    dist[start] = 0;
+    size_t frontierSize = 1;
+    size_t frontierEdges = rowOf(source).size();
+    size_t unexploredEdges = edgeTotal > frontierEdges ? edgeTotal - frontierEdges : 0;
+    bool bottomUp = false;
 
-    while (!q.empty()) {
-        int u = q.front(); q.pop();
-        for (int v : adjacencyList[u]) {
-            if (!dist.count(v)) {
-                dist[v] = dist[u] + 1;
-                q.push(v);
+    for (int level = 1; frontierSize > 0; ++level) {
+        if (!bottomUp && frontierEdges > unexploredEdges / TopDownAlpha)
+            bottomUp = true;
+        else if (bottomUp && frontierSize < static_cast<size_t>(n) / BottomUpBeta)
+            bottomUp = false;
+
+        atomic<size_t> found(0), foundEdges(0);
+        parallelFor(threads, words, WordsPerChunk, [&](size_t begin, size_t end) {
+            size_t localFound = 0, localEdges = 0;
+            for (size_t w = begin; w < end; ++w) {
+                if (bottomUp) {
+                    // Each word of `next` is written by exactly one chunk.
+                    uint64_t open = ~visited.load(w);
+                    if (w == words - 1 && (n & 63)) open &= (uint64_t(1) << (n & 63)) - 1;
+                    uint64_t hits = 0;
+                    for (; open; open &= open - 1) {
+                        int v = static_cast<int>(w * 64 + lowestSetBit(open));
+                        const auto& row = rowOf(v);
+                        for (int u : row) {
+                            if (frontier.test(u)) {
+                                hits |= open & (~open + 1);
+                                dist.set(v, level);
+                                ++localFound;
+                                localEdges += row.size();
+                                break;
+                            }
+                        }
+                    }
+                    next.word(w).store(hits, memory_order_relaxed);
+                }
+                else {
+                    for (uint64_t bits = frontier.load(w); bits; bits &= bits - 1) {
+                        int u = static_cast<int>(w * 64 + lowestSetBit(bits));
+                        for (int v : rowOf(u)) {
+                            if (!visited.claim(v)) continue;
+                            next.claim(v);
+                            dist.set(v, level);
+                            ++localFound;
+                            localEdges += rowOf(v).size();
+                        }
+                    }
+                }
             }
+            found += localFound;
+            foundEdges += localEdges;
+            });
+
+        // Publish the new level: record it in BFS order and, after a
+        // bottom-up step, fold it into the visited set.
+        for (size_t w = 0; w < words; ++w) {
+            uint64_t bits = next.load(w);
+            if (!bits) continue;
+            if (bottomUp) visited.word(w).fetch_or(bits, memory_order_relaxed);
+            for (; bits; bits &= bits - 1)
+                ws.order.push_back(static_cast<int>(w * 64 + lowestSetBit(bits)));
         }
+        frontier.swap(next);
+        for (size_t w = 0; w < words; ++w)
+            next.word(w).store(0, memory_order_relaxed);
+
+        frontierSize = found;
+        frontierEdges = foundEdges;
+        unexploredEdges = unexploredEdges > frontierEdges ? unexploredEdges - frontierEdges : 0;
     }
-    return dist;
 }
 
-bool GraphAlgorithms::isConnected(int start, int totalVertices) {
-    auto dist = breadthFirstSearch(start);
-    return dist.size() == totalVertices;
+DistanceView GraphAlgorithms::breadthFirstSearch(int start, Layer layer) {
+    const auto& data = layerData(layer);
+    workspace.prepare(slotCount());
+    DistanceView view(workspace.distance, workspace.order, layerSlotId, layerSlotOf);
+    int s = findSlot(start);
+    if (s < 0 || data.adjacency[s].empty()) return view;
+
+    auto rowOf = [&data](int v) -> const vector<int>& { return data.adjacency[v]; };
+    frontierSearch(slotCount(), 2 * data.multiplicity.size(), s, rowOf, workspace, threadCount);
+    return view;
 }
 
-map<int, int> GraphAlgorithms::dijkstra(int start) {
-    map<int, int> dist;
-    for (const auto& kv : adjacencyList) {
-        dist[kv.first] = numeric_limits<int>::max();
+// Multi-source BFS (Then et al.): every vertex carries a 64-bit mask per
+// state (seen, visit, next) with one bit per source, so up to 64 searches
+// share each edge scan. A small frontier expands top-down; a large one
+// bottom-up, where each vertex ORs its neighbors' visit masks and writes
+// only its own entries, so chunks of vertices run on separate threads.
+// Longer source lists run as consecutive batches of 64.
+static const size_t LaneCount = 64;
+static const size_t VerticesPerChunk = 1024;
+
+template <typename RowOf>
+static void multiSourceSearch(int n, size_t edgeTotal, const vector<int>& sources, RowOf rowOf,
+    SearchWorkspace& ws, int threads, BatchDistances& result) {
+    auto& seen = ws.seenLanes;
+    auto& visit = ws.visitLanes;
+    auto& next = ws.nextLanes;
+    auto& active = ws.order;
+    auto& found = ws.reverseOrder;
+
+    for (size_t first = 0; first < sources.size(); first += LaneCount) {
+        size_t lanes = min(LaneCount, sources.size() - first);
+        uint64_t allLanes = lanes == 64 ? ~uint64_t(0) : (uint64_t(1) << lanes) - 1;
+        seen.assign(n, 0);
+        visit.assign(n, 0);
+        next.assign(n, 0);
+        active.clear();
+
+        size_t frontierEdges = 0;
+        for (size_t i = 0; i < lanes; ++i) {
+            int s = sources[first + i];
+            if (s < 0) continue;
+            if (!visit[s]) {
+                active.push_back(s);
+                frontierEdges += rowOf(s).size();
+            }
+            seen[s] |= uint64_t(1) << i;
+            visit[s] |= uint64_t(1) << i;
+            result.row(first + i)[s] = 0;
+        }
+        size_t unexploredEdges = edgeTotal > frontierEdges ? edgeTotal - frontierEdges : 0;
+        bool bottomUp = false;
+
+        for (int level = 1; !active.empty(); ++level) {
+            if (!bottomUp && frontierEdges > unexploredEdges / TopDownAlpha)
+                bottomUp = true;
+            else if (bottomUp && active.size() < static_cast<size_t>(n) / BottomUpBeta)
+                bottomUp = false;
+
+            found.clear();
+            if (bottomUp) {
+                parallelFor(threads, n, VerticesPerChunk, [&](size_t begin, size_t end) {
+                    for (size_t v = begin; v < end; ++v) {
+                        uint64_t open = allLanes & ~seen[v];
+                        if (!open) continue;
+                        uint64_t reached = 0;
+                        for (int u : rowOf(static_cast<int>(v))) {
+                            reached |= visit[u];
+                            if ((reached & open) == open) break;
+                        }
+                        uint64_t fresh = reached & open;
+                        if (!fresh) continue;
+                        seen[v] |= fresh;
+                        next[v] = fresh;
+                        for (; fresh; fresh &= fresh - 1)
+                            result.row(first + lowestSetBit(fresh))[v] = level;
+                    }
+                    });
+                for (int v = 0; v < n; ++v)
+                    if (next[v]) found.push_back(v);
+            }
+            else {
+                for (int u : active) {
+                    for (int v : rowOf(u)) {
+                        uint64_t fresh = visit[u] & ~seen[v];
+                        if (!fresh) continue;
+                        if (!next[v]) found.push_back(v);
+                        seen[v] |= fresh;
+                        next[v] |= fresh;
+                        for (; fresh; fresh &= fresh - 1)
+                            result.row(first + lowestSetBit(fresh))[v] = level;
+                    }
+                }
+            }
+
+            // The new level becomes the frontier; the old one is cleared so
+            // the swapped-in `next` starts empty.
+            for (int u : active) visit[u] = 0;
+            visit.swap(next);
+            active.swap(found);
+            frontierEdges = 0;
+            for (int v : active) frontierEdges += rowOf(v).size();
+            unexploredEdges = unexploredEdges > frontierEdges ? unexploredEdges - frontierEdges : 0;
+        }
+    }
+}
+
+BatchDistances GraphAlgorithms::multiSourceBfs(const vector<int>& sources, Layer layer) {
+    const auto& data = layerData(layer);
+    workspace.prepare(slotCount());
+    BatchDistances result(sources, slotCount(), layerSlotId, layerSlotOf);
+    vector<int> dense(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        int s = findSlot(sources[i]);
+        dense[i] = s >= 0 && !data.adjacency[s].empty() ? s : -1;
     }
-    if (dist.count(start) == 0) return {};
-    dist[start] = 0;
 
-    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
-    pq.push({ 0, start });
+    auto rowOf = [&data](int v) -> const vector<int>& { return data.adjacency[v]; };
+    multiSourceSearch(slotCount(), 2 * data.multiplicity.size(), dense, rowOf, workspace, threadCount, result);
+    return result;
+}
+
+bool GraphAlgorithms::isConnected(int start, int totalVertices, Layer layer) {
+    const auto& data = layerData(layer);
+    int s = findSlot(start);
+    if (s < 0 || data.adjacency[s].empty()) return false;
+    return data.presentVertices == totalVertices && componentCount(layer) == 1;
+}
+
+DistanceView GraphAlgorithms::dijkstra(int start, Layer layer) {
+    const auto& adjacency = adjacencyOf(layer);
+    workspace.prepare(slotCount());
+    DistanceView view(workspace.distance, workspace.order, layerSlotId, layerSlotOf);
+    int s = findSlot(start);
+    if (s < 0 || adjacency[s].empty()) return view;
+
+    auto& dist = workspace.distance;
+    auto& heap = workspace.heap;
+    greater<pair<int, int>> later;
+    dist.set(s, 0);
+    heap.push_back({ 0, s });
 
-    while (!pq.empty()) {
-        auto top = pq.top(); pq.pop();
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), later);
+        auto top = heap.back(); heap.pop_back();
         int d = top.first, u = top.second;
-        if (d > dist[u]) continue;
+        if (d > dist.get(u)) continue;
+        workspace.order.push_back(u);
 
-        for (int v : adjacencyList[u]) {
-            if (dist[u] + 1 < dist[v]) {
-                dist[v] = dist[u] + 1;
-                pq.push({ dist[v], v });
+        for (int v : adjacency[u]) {
+            if (!dist.has(v) || d + 1 < dist.get(v)) {
+                dist.set(v, d + 1);
+                heap.push_back({ d + 1, v });
+                push_heap(heap.begin(), heap.end(), later);
             }
         }
     }
-    return dist;
+    return view;
 }
 
-map<int, double> GraphAlgorithms::computeDegreeCentrality() {
-    map<int, double> degree;
-    for (const auto& kv : adjacencyList) {
-        degree[kv.first] = static_cast<int>(kv.second.size());
+ScoreView GraphAlgorithms::computeDegreeCentrality(Layer layer) {
+    const auto& adjacency = adjacencyOf(layer);
+    workspace.prepare(slotCount());
+    for (int v = 0; v < slotCount(); ++v) {
+        if (adjacency[v].empty()) continue;
+        workspace.score.set(v, static_cast<double>(adjacency[v].size()));
+        workspace.order.push_back(v);
     }
-    return degree;
+    return ScoreView(workspace.score, workspace.order, layerSlotId, layerSlotOf);
 }
 
-bool GraphAlgorithms::hasCycle() {
-    set<int> visited;
-    for (const auto& kv : adjacencyList) {
-        int node = kv.first;
-        if (!visited.count(node)) {
-            if (hasCycleUtil(node, -1, visited)) return true;
+static const size_t BrandesSourcesPerChunk = 4;
+
+// Per-worker Brandes state: BFS buffers plus the worker's own dependency
+// totals, summed once every source is done.
+struct BrandesScratch {
+    vector<int> dist;
+    vector<double> sigma, delta, total;
+    vector<int> order;
+    explicit BrandesScratch(size_t n) : dist(n, -1), sigma(n, 0), delta(n, 0), total(n, 0) {}
+};
+
+// Adds the dependencies of every vertex on shortest paths from s to b.total.
+// Predecessors are found again by rescanning rows instead of being stored.
+template <typename RowOf>
+static void accumulateDependencies(int s, RowOf rowOf, BrandesScratch& b) {
+    auto& order = b.order;
+    order.clear();
+    b.dist[s] = 0;
+    b.sigma[s] = 1;
+    order.push_back(s);
+    for (size_t head = 0; head < order.size(); ++head) {
+        int u = order[head];
+        for (int v : rowOf(u)) {
+            if (b.dist[v] < 0) {
+                b.dist[v] = b.dist[u] + 1;
+                order.push_back(v);
+            }
+            if (b.dist[v] == b.dist[u] + 1) b.sigma[v] += b.sigma[u];
         }
     }
-    return false;
+    for (size_t i = order.size(); i-- > 1;) {
+        int w = order[i];
+        double coefficient = (1 + b.delta[w]) / b.sigma[w];
+        for (int v : rowOf(w))
+            if (b.dist[v] == b.dist[w] - 1) b.delta[v] += b.sigma[v] * coefficient;
+        b.total[w] += b.delta[w];
+    }
+    for (int v : order) {
+        b.dist[v] = -1;
+        b.sigma[v] = 0;
+        b.delta[v] = 0;
+    }
+}
+
+// Betweenness of n dense vertices from the given sources, parallel over
+// sources. Undirected rows see every pair from both ends, hence the half.
+template <typename RowOf>
+static vector<double> brandes(size_t n, const vector<int>& sources, RowOf rowOf, double scale, int threads) {
+    ScratchPool<BrandesScratch> pool;
+    parallelFor(threads, sources.size(), BrandesSourcesPerChunk, [&](size_t begin, size_t end) {
+        BrandesScratch* scratch = pool.acquire([n] { return new BrandesScratch(n); });
+        for (size_t i = begin; i < end; ++i)
+            accumulateDependencies(sources[i], rowOf, *scratch);
+        pool.release(scratch);
+        });
+
+    vector<double> result(n, 0.0);
+    for (const auto& scratch : pool.all())
+        for (size_t v = 0; v < n; ++v) result[v] += scratch->total[v];
+    for (auto& r : result) r *= scale / 2;
+    return result;
+}
+
+// k sources drawn without replacement, or all of them when k is 0 or
+// covers every candidate; scale makes the sampled sum estimate the full one.
+static vector<int> pickSources(vector<int> candidates, int samples, unsigned seed, double& scale) {
+    scale = 1.0;
+    size_t k = static_cast<size_t>(samples);
+    if (samples <= 0 || k >= candidates.size()) return candidates;
+    mt19937 rng(seed);
+    for (size_t i = 0; i < k; ++i) {
+        uniform_int_distribution<size_t> pick(i, candidates.size() - 1);
+        swap(candidates[i], candidates[pick(rng)]);
+    }
+    scale = static_cast<double>(candidates.size()) / k;
+    candidates.resize(k);
+    return candidates;
+}
+
+ScoreView GraphAlgorithms::betweennessCentrality(Layer layer, int samples, unsigned seed) {
+    const auto& adjacency = adjacencyOf(layer);
+    workspace.prepare(slotCount());
+    for (int v = 0; v < slotCount(); ++v)
+        if (!adjacency[v].empty()) workspace.order.push_back(v);
+
+    double scale;
+    auto sources = pickSources(workspace.order, samples, seed, scale);
+    auto rowOf = [&adjacency](int v) -> const vector<int>& { return adjacency[v]; };
+    auto scores = brandes(adjacency.size(), sources, rowOf, scale, threadCount);
+    for (int v : workspace.order) workspace.score.set(v, scores[v]);
+    return ScoreView(workspace.score, workspace.order, layerSlotId, layerSlotOf);
 }
 
-bool GraphAlgorithms::hasCycleUtil(int v, int parent, set<int>& visited) {
-    visited.insert(v);
-    for (int u : adjacencyList[v]) {
-        if (!visited.count(u)) {
-            if (hasCycleUtil(u, v, visited)) return true;
+double GraphAlgorithms::betweennessErrorBound(int vertices, int samples, double confidence) {
+    if (samples <= 0 || samples >= vertices || vertices < 3) return 0.0;
+    // Each sampled source adds n * delta / 2 with delta in [0, n - 2].
+    double range = static_cast<double>(vertices) * (vertices - 2) / 2;
+    return range * sqrt(log(2.0 / (1.0 - confidence)) / (2.0 * samples));
+}
+
+static const size_t PeelChunk = 1024;
+
+// Batagelj-Zaversnik: vertices sit in buckets by current degree and are
+// removed lowest bucket first; a removal moves each remaining neighbor
+// down one bucket with a swap. O(n + m).
+template <typename RowOf>
+static void coresByBuckets(int n, RowOf rowOf, vector<int>& core) {
+    core.assign(n, 0);
+    int maxDegree = 0;
+    for (int v = 0; v < n; ++v) {
+        for (int u : rowOf(v))
+            if (u != v) ++core[v];
+        maxDegree = max(maxDegree, core[v]);
+    }
+    // bucketStart[d]: first position of degree d in order; position[v]: v's place.
+    vector<int> bucketStart(maxDegree + 2, 0), order(n), position(n);
+    for (int v = 0; v < n; ++v) ++bucketStart[core[v] + 1];
+    for (int d = 0; d <= maxDegree; ++d) bucketStart[d + 1] += bucketStart[d];
+    vector<int> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (int v = 0; v < n; ++v) {
+        position[v] = fill[core[v]]++;
+        order[position[v]] = v;
+    }
+    for (int i = 0; i < n; ++i) {
+        int v = order[i];
+        for (int u : rowOf(v)) {
+            if (core[u] <= core[v]) continue;
+            // Swap u with the first vertex of its bucket, then shrink the bucket.
+            int du = core[u], first = bucketStart[du], w = order[first];
+            if (w != u) {
+                swap(order[position[u]], order[first]);
+                swap(position[u], position[w]);
+            }
+            ++bucketStart[du];
+            --core[u];
+        }
+    }
+}
+
+// Level-synchronous peeling: for k = 0, 1, ... every vertex whose degree
+// has fallen to k is removed in parallel, atomically lowering its
+// neighbors' degrees; a neighbor that lands on k joins the next round.
+template <typename RowOf>
+static void coresByPeeling(int n, RowOf rowOf, vector<int>& core, int threads) {
+    core.assign(n, 0);
+    unique_ptr<atomic<int>[]> degree(new atomic<int>[n]);
+    vector<char> removed(n, 0);
+    vector<int> alive, frontier, next;
+    for (int v = 0; v < n; ++v) {
+        int d = 0;
+        for (int u : rowOf(v))
+            if (u != v) ++d;
+        degree[v].store(d, memory_order_relaxed);
+        alive.push_back(v);
+    }
+
+    mutex appendLock;
+    auto append = [&appendLock](vector<int>& to, const vector<int>& local) {
+        if (local.empty()) return;
+        lock_guard<mutex> hold(appendLock);
+        to.insert(to.end(), local.begin(), local.end());
+    };
+    for (int k = 0; !alive.empty(); ++k) {
+        frontier.clear();
+        parallelFor(threads, alive.size(), PeelChunk, [&](size_t begin, size_t end) {
+            vector<int> local;
+            for (size_t i = begin; i < end; ++i)
+                if (degree[alive[i]].load(memory_order_relaxed) <= k) local.push_back(alive[i]);
+            append(frontier, local);
+            });
+        while (!frontier.empty()) {
+            for (int v : frontier) {
+                removed[v] = 1;
+                core[v] = k;
+            }
+            next.clear();
+            parallelFor(threads, frontier.size(), PeelChunk, [&](size_t begin, size_t end) {
+                vector<int> local;
+                for (size_t i = begin; i < end; ++i)
+                    for (int u : rowOf(frontier[i])) {
+                        if (removed[u]) continue;
+                        // Exactly one decrement takes u from k + 1 to k.
+                        if (degree[u].fetch_sub(1, memory_order_relaxed) == k + 1) local.push_back(u);
+                    }
+                append(next, local);
+                });
+            frontier.swap(next);
         }
-        else if (u != parent) {
-            return true;
+        alive.erase(remove_if(alive.begin(), alive.end(), [&removed](int v) { return removed[v] != 0; }), alive.end());
+    }
+}
+
+template <typename RowOf>
+static void coreDecompose(int n, RowOf rowOf, vector<int>& core, int threads) {
+    if (resolveThreads(threads) <= 1) coresByBuckets(n, rowOf, core);
+    else coresByPeeling(n, rowOf, core, threads);
+}
+
+CountView GraphAlgorithms::coreNumbers(Layer layer) {
+    const auto& adjacency = adjacencyOf(layer);
+    vector<int> core;
+    coreDecompose(slotCount(), [&adjacency](int v) -> const vector<int>& { return adjacency[v]; }, core, threadCount);
+    workspace.prepare(slotCount());
+    for (int v = 0; v < slotCount(); ++v) {
+        if (adjacency[v].empty()) continue;
+        workspace.distance.set(v, core[v]);
+        workspace.order.push_back(v);
+    }
+    return CountView(workspace.distance, workspace.order, layerSlotId, layerSlotOf);
+}
+
+// Undirected cycle search by an explicit-stack traversal over dense
+// arrays, so a long chain cannot overflow the call stack. A vertex seen
+// again through anything but the edge it was reached by closes a cycle.
+template <typename RowOf>
+static bool undirectedCycle(int n, RowOf rowOf) {
+    vector<int> parent(n, -2);
+    vector<int> stack;
+    for (int root = 0; root < n; ++root) {
+        if (parent[root] != -2) continue;
+        parent[root] = -1;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            for (int u : rowOf(v)) {
+                if (parent[u] == -2) {
+                    parent[u] = v;
+                    stack.push_back(u);
+                }
+                else if (u != parent[v]) {
+                    return true;
+                }
+            }
         }
     }
     return false;
 }
 
-vector<vector<int>> GraphAlgorithms::findTriangles() {
+bool GraphAlgorithms::hasCycle(Layer layer) {
+    const auto& adjacency = adjacencyOf(layer);
+    return undirectedCycle(slotCount(), [&adjacency](int v) -> const vector<int>& { return adjacency[v]; });
+}
+
+// Compact-forward triangle listing (Latapy): vertices are ranked by
+// (degree, index) and every edge points from the lower to the higher rank.
+// Each triangle is then found once, at its lowest-ranked corner, by
+// intersecting two sorted out-lists, and hubs keep short out-lists.
+// Work is split across threads by ranges of ranks.
+struct ForwardGraph {
+    vector<int> offsets;
+    vector<int> targets;
+    vector<int> vertexOf;
+
+    int size() const { return static_cast<int>(vertexOf.size()); }
+    const int* begin(int r) const { return targets.data() + offsets[r]; }
+    const int* end(int r) const { return targets.data() + offsets[r + 1]; }
+};
+
+static const size_t RanksPerChunk = 256;
+
+template <typename RowOf>
+static void orientByDegree(int n, RowOf rowOf, int threads, ForwardGraph& fg) {
+    fg.vertexOf.resize(n);
+    for (int v = 0; v < n; ++v) fg.vertexOf[v] = v;
+    sort(fg.vertexOf.begin(), fg.vertexOf.end(), [&rowOf](int a, int b) {
+        size_t da = rowOf(a).size(), db = rowOf(b).size();
+        return da != db ? da < db : a < b;
+        });
+    vector<int> rankOf(n);
+    for (int r = 0; r < n; ++r) rankOf[fg.vertexOf[r]] = r;
+
+    fg.offsets.assign(n + 1, 0);
+    for (int r = 0; r < n; ++r) {
+        int out = 0;
+        for (int u : rowOf(fg.vertexOf[r]))
+            if (rankOf[u] > r) ++out;
+        fg.offsets[r + 1] = fg.offsets[r] + out;
+    }
+    fg.targets.resize(fg.offsets[n]);
+    parallelFor(threads, n, RanksPerChunk, [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+            int* out = fg.targets.data() + fg.offsets[r];
+            for (int u : rowOf(fg.vertexOf[r]))
+                if (rankOf[u] > static_cast<int>(r)) *out++ = rankOf[u];
+            sort(fg.targets.data() + fg.offsets[r], out);
+        }
+        });
+}
+
+// Calls onTriangle(r, s, t) with ranks r < s < t for every triangle whose
+// lowest rank is r; scratch holds the intersections.
+template <typename OnTriangle>
+static void trianglesAt(const ForwardGraph& fg, int r, vector<int>& scratch, OnTriangle onTriangle) {
+    const int* last = fg.end(r);
+    if (scratch.size() < static_cast<size_t>(last - fg.begin(r))) scratch.resize(last - fg.begin(r));
+    for (const int* sv = fg.begin(r); sv != last; ++sv) {
+        size_t found = intersectSorted(sv + 1, last - sv - 1, fg.begin(*sv), fg.end(*sv) - fg.begin(*sv), scratch.data());
+        for (size_t i = 0; i < found; ++i)
+            onTriangle(r, *sv, scratch[i]);
+    }
+}
+
+static long long countForward(const ForwardGraph& fg, int threads) {
+    atomic<long long> total(0);
+    parallelFor(threads, fg.size(), RanksPerChunk, [&](size_t begin, size_t end) {
+        long long local = 0;
+        for (size_t r = begin; r < end; ++r) {
+            const int* last = fg.end(static_cast<int>(r));
+            for (const int* sv = fg.begin(static_cast<int>(r)); sv != last; ++sv)
+                local += intersectCount(sv + 1, last - sv - 1, fg.begin(*sv), fg.end(*sv) - fg.begin(*sv));
+        }
+        total += local;
+        });
+    return total;
+}
+
+// Triangles through each vertex, by vertex index.
+static void countForwardPerVertex(const ForwardGraph& fg, int threads, vector<long long>& counts) {
+    int n = fg.size();
+    unique_ptr<atomic<long long>[]> shared(new atomic<long long>[n]);
+    for (int v = 0; v < n; ++v) shared[v].store(0, memory_order_relaxed);
+    parallelFor(threads, n, RanksPerChunk, [&](size_t begin, size_t end) {
+        vector<int> scratch;
+        for (size_t r = begin; r < end; ++r) {
+            long long own = 0;
+            trianglesAt(fg, static_cast<int>(r), scratch, [&](int, int s, int t) {
+                ++own;
+                shared[fg.vertexOf[s]].fetch_add(1, memory_order_relaxed);
+                shared[fg.vertexOf[t]].fetch_add(1, memory_order_relaxed);
+                });
+            if (own) shared[fg.vertexOf[r]].fetch_add(own, memory_order_relaxed);
+        }
+        });
+    counts.resize(n);
+    for (int v = 0; v < n; ++v) counts[v] = shared[v].load(memory_order_relaxed);
+}
+
+// Triangles as sorted ID triples; chunks are joined in rank order, so the
+// result does not depend on the thread count.
+template <typename IdOf>
+static vector<vector<int>> listForward(const ForwardGraph& fg, IdOf idOf, int threads) {
+    size_t chunks = (static_cast<size_t>(fg.size()) + RanksPerChunk - 1) / RanksPerChunk;
+    vector<vector<int>> found(chunks);
+    parallelFor(threads, fg.size(), RanksPerChunk, [&](size_t begin, size_t end) {
+        auto& out = found[begin / RanksPerChunk];
+        vector<int> scratch;
+        for (size_t r = begin; r < end; ++r) {
+            trianglesAt(fg, static_cast<int>(r), scratch, [&](int a, int b, int c) {
+                int ids[3] = { idOf(fg.vertexOf[a]), idOf(fg.vertexOf[b]), idOf(fg.vertexOf[c]) };
+                sort(ids, ids + 3);
+                out.insert(out.end(), ids, ids + 3);
+                });
+        }
+        });
+
     vector<vector<int>> triangles;
-    map<int, set<int>> adjSet;
-    for (auto& kv : adjacencyList) {
-        adjSet[kv.first] = set<int>(kv.second.begin(), kv.second.end());
-    }
-
-    for (auto& ku : adjacencyList) {
-        int u = ku.first;
-        for (int v : ku.second) {
-            if (v <= u) continue;
-            for (int w : adjacencyList[v]) {
-                if (w <= v) continue;
-                if (adjSet[w].count(u)) {
-                    triangles.push_back({ u, v, w });
+    size_t total = 0;
+    for (const auto& chunk : found) total += chunk.size() / 3;
+    triangles.reserve(total);
+    for (const auto& chunk : found)
+        for (size_t i = 0; i < chunk.size(); i += 3)
+            triangles.push_back({ chunk[i], chunk[i + 1], chunk[i + 2] });
+    return triangles;
+}
+
+vector<vector<int>> GraphAlgorithms::findTriangles(Layer layer) {
+    const auto& adjacency = adjacencyOf(layer);
+    ForwardGraph fg;
+    orientByDegree(slotCount(), [&adjacency](int v) -> const vector<int>& { return adjacency[v]; }, threadCount, fg);
+    return listForward(fg, [this](int v) { return layerSlotId[v]; }, threadCount);
+}
+
+long long GraphAlgorithms::countTriangles(Layer layer) {
+    const auto& adjacency = adjacencyOf(layer);
+    ForwardGraph fg;
+    orientByDegree(slotCount(), [&adjacency](int v) -> const vector<int>& { return adjacency[v]; }, threadCount, fg);
+    return countForward(fg, threadCount);
+}
+
+ScoreView GraphAlgorithms::triangleCounts(Layer layer) {
+    const auto& adjacency = adjacencyOf(layer);
+    ForwardGraph fg;
+    orientByDegree(slotCount(), [&adjacency](int v) -> const vector<int>& { return adjacency[v]; }, threadCount, fg);
+    vector<long long> counts;
+    countForwardPerVertex(fg, threadCount, counts);
+
+    workspace.prepare(slotCount());
+    for (int v = 0; v < slotCount(); ++v) {
+        if (!counts[v]) continue;
+        workspace.score.set(v, static_cast<double>(counts[v]));
+        workspace.order.push_back(v);
+    }
+    return ScoreView(workspace.score, workspace.order, layerSlotId, layerSlotOf);
+}
+
+int GraphAlgorithms::bidirectionalSearch(int s, int t, const vector<vector<int>>& adjacency, int& meetFrom, int& meetTo) {
+    meetFrom = meetTo = s;
+    if (s == t) return 0;
+
+    workspace.prepare(slotCount());
+    workspace.distance.set(s, 0);
+    workspace.parent.set(s, -1);
+    workspace.order.push_back(s);
+    workspace.reverseDistance.set(t, 0);
+    workspace.reverseParent.set(t, -1);
+    workspace.reverseOrder.push_back(t);
+
+    // Each side's queue holds whole levels; [head, size) is the frontier.
+    size_t forwardHead = 0, backwardHead = 0;
+    while (forwardHead < workspace.order.size() && backwardHead < workspace.reverseOrder.size()) {
+        bool forward = workspace.order.size() - forwardHead <= workspace.reverseOrder.size() - backwardHead;
+        auto& queue = forward ? workspace.order : workspace.reverseOrder;
+        auto& dist = forward ? workspace.distance : workspace.reverseDistance;
+        auto& parent = forward ? workspace.parent : workspace.reverseParent;
+        const auto& otherDist = forward ? workspace.reverseDistance : workspace.distance;
+        size_t& head = forward ? forwardHead : backwardHead;
+
+        // Finish the whole level before stopping, so the shortest of the
+        // meeting edges found on it wins.
+        int best = -1;
+        size_t levelEnd = queue.size();
+        for (; head < levelEnd; ++head) {
+            int u = queue[head];
+            for (int v : adjacency[u]) {
+                if (otherDist.has(v)) {
+                    int length = dist.get(u) + 1 + otherDist.get(v);
+                    if (best < 0 || length < best) {
+                        best = length;
+                        meetFrom = forward ? u : v;
+                        meetTo = forward ? v : u;
+                    }
+                }
+                else if (!dist.has(v)) {
+                    dist.set(v, dist.get(u) + 1);
+                    parent.set(v, u);
+                    queue.push_back(v);
                 }
             }
         }
+        if (best >= 0) return best;
     }
-    return triangles;
+    return -1;
+}
+
+bool GraphAlgorithms::hasPath(int from, int to, Layer layer) {
+    return pathLength(from, to, layer) >= 0;
+}
+
+int GraphAlgorithms::pathLength(int from, int to, Layer layer) {
+    const auto& adjacency = adjacencyOf(layer);
+    int s = findSlot(from), t = findSlot(to);
+    if (s < 0 || t < 0 || adjacency[s].empty() || adjacency[t].empty()) return -1;
+    int meetFrom, meetTo;
+    return bidirectionalSearch(s, t, adjacency, meetFrom, meetTo);
+}
+
+vector<int> GraphAlgorithms::shortestPath(int from, int to, Layer layer) {
+    const auto& adjacency = adjacencyOf(layer);
+    int s = findSlot(from), t = findSlot(to);
+    if (s < 0 || t < 0 || adjacency[s].empty() || adjacency[t].empty()) return {};
+    int meetFrom, meetTo;
+    int length = bidirectionalSearch(s, t, adjacency, meetFrom, meetTo);
+    if (length < 0) return {};
+    if (length == 0) return { from };
+
+    vector<int> path;
+    path.reserve(length + 1);
+    for (int v = meetFrom; v >= 0; v = workspace.parent.get(v))
+        path.push_back(layerSlotId[v]);
+    reverse(path.begin(), path.end());
+    for (int v = meetTo; v >= 0; v = workspace.reverseParent.get(v))
+        path.push_back(layerSlotId[v]);
+    return path;
+}
+
+
+CountView GraphAlgorithms::twoHopNeighbors(int id, Layer layer) {
+    const auto& adjacency = adjacencyOf(layer);
+    workspace.prepare(slotCount());
+    CountView view(workspace.distance, workspace.order, layerSlotId, layerSlotOf);
+    int s = findSlot(id);
+    if (s < 0) return view;
+
+    auto& shared = workspace.distance;
+    for (int middle : adjacency[s]) {
+        for (int v : adjacency[middle]) {
+            if (v == s) continue;
+            if (shared.has(v)) {
+                shared.set(v, shared.get(v) + 1);
+            }
+            else {
+                shared.set(v, 1);
+                workspace.order.push_back(v);
+            }
+        }
+    }
+    return view;
+}
+
+static const size_t SourcesPerChunk = 64;
+
+// Scores the two-hop candidates of s in ws.score, listing them in ws.order.
+// The heap keeps the k best as a min-heap: the root is the weakest kept
+// candidate, and a tie on score drops the higher ID first.
+static void topLinks(const vector<vector<int>>& adjacency, const vector<int>& layerSlotId, int s, int k,
+    LinkScore kind, SearchWorkspace& ws, vector<Recommendation>& out) {
+    out.clear();
+    if (k <= 0 || adjacency[s].empty()) return;
+    auto& score = ws.score;
+    auto& candidates = ws.order;
+    score.resize(adjacency.size());
+    score.reset();
+    candidates.clear();
+
+    // Existing neighbors and s itself are marked with -1 and never scored.
+    score.set(s, -1);
+    for (int m : adjacency[s]) score.set(m, -1);
+    for (int m : adjacency[s]) {
+        size_t degree = adjacency[m].size();
+        double weight = 1.0;
+        if (kind == LinkScore::AdamicAdar) {
+            if (degree < 2) continue;
+            weight = 1.0 / log(static_cast<double>(degree));
+        }
+        else if (kind == LinkScore::ResourceAllocation) {
+            weight = 1.0 / degree;
+        }
+        for (int v : adjacency[m]) {
+            if (!score.has(v)) {
+                score.set(v, weight);
+                candidates.push_back(v);
+            }
+            else if (score.get(v) >= 0) {
+                score.set(v, score.get(v) + weight);
+            }
+        }
+    }
+
+    // (score, -ID) orders better candidates higher; greater<> makes a min-heap.
+    auto& heap = ws.ranked;
+    heap.clear();
+    greater<pair<double, int>> weaker;
+    for (int v : candidates) {
+        pair<double, int> item(score.get(v), -layerSlotId[v]);
+        if (heap.size() < static_cast<size_t>(k)) {
+            heap.push_back(item);
+            push_heap(heap.begin(), heap.end(), weaker);
+        }
+        else if (item > heap.front()) {
+            pop_heap(heap.begin(), heap.end(), weaker);
+            heap.back() = item;
+            push_heap(heap.begin(), heap.end(), weaker);
+        }
+    }
+    sort(heap.begin(), heap.end(), greater<pair<double, int>>());
+    for (const auto& item : heap)
+        out.push_back({ -item.second, item.first });
+}
+
+vector<Recommendation> GraphAlgorithms::recommend(int id, int k, LinkScore score, Layer layer) {
+    vector<Recommendation> result;
+    int s = findSlot(id);
+    if (s < 0) return result;
+    topLinks(adjacencyOf(layer), layerSlotId, s, k, score, workspace, result);
+    return result;
+}
+
+vector<pair<int, vector<Recommendation>>> GraphAlgorithms::recommendAll(int k, LinkScore score, Layer layer) {
+    const auto& adjacency = adjacencyOf(layer);
+    vector<int> sources;
+    for (int v = 0; v < slotCount(); ++v)
+        if (!adjacency[v].empty()) sources.push_back(v);
+    vector<pair<int, vector<Recommendation>>> result(sources.size());
+
+    // One workspace per worker: a chunk borrows a free one and hands it back.
+    ScratchPool<SearchWorkspace> pool;
+    parallelFor(threadCount, sources.size(), SourcesPerChunk, [&](size_t begin, size_t end) {
+        SearchWorkspace* scratch = pool.acquire([] { return new SearchWorkspace(); });
+        for (size_t i = begin; i < end; ++i) {
+            result[i].first = layerSlotId[sources[i]];
+            topLinks(adjacency, layerSlotId, sources[i], k, score, *scratch, result[i].second);
+        }
+        pool.release(scratch);
+        });
+    return result;
+}
+
+void GraphAlgorithms::enableDistanceOracle(int landmarks, Layer layer) {
+    if (pendingOracle.valid()) pendingOracle.wait();
+    pendingOracle = {};
+    oracle.reset();
+    oracleLandmarks = landmarks > 0 ? landmarks : 0;
+    oracleLayer = layer;
+    refreshDistanceOracle();
+}
+
+void GraphAlgorithms::refreshDistanceOracle() {
+    if (!oracleLandmarks) return;
+    if (pendingOracle.valid() && pendingOracle.wait_for(chrono::seconds(0)) == future_status::ready)
+        oracle = pendingOracle.get();
+    unsigned long long current = getEpoch(oracleLayer);
+    if (pendingOracle.valid() || (oracle && oracle->epoch() == current)) return;
+
+    // The copy keeps the build independent of later mutations.
+    CsrGraph g = currentSnapshot(oracleLayer);
+    int landmarks = oracleLandmarks, threads = threadCount;
+    pendingOracle = async(launch::async, [g = move(g), landmarks, current, threads]() {
+        return shared_ptr<const DistanceOracle>(
+            make_shared<DistanceOracle>(DistanceOracle::build(g, landmarks, current, threads)));
+        });
+}
+
+void GraphAlgorithms::waitForDistanceOracle() {
+    refreshDistanceOracle();
+    while (pendingOracle.valid()) {
+        pendingOracle.wait();
+        refreshDistanceOracle();
+    }
+}
+
+DistanceEstimate GraphAlgorithms::estimateDistance(int a, int b) {
+    refreshDistanceOracle();
+    if (!oracle) return DistanceEstimate();
+    auto result = oracle->estimate(a, b);
+    if (oracle->epoch() != getEpoch(oracleLayer)) result.exact = false;
+    return result;
+}
+
+CsrGraph GraphAlgorithms::snapshot(Layer layer) const {
+    return CsrGraph::fromDense(layerData(layer).adjacency, layerSlotId);
+}
+
+const CsrGraph& GraphAlgorithms::currentSnapshot(Layer layer) const {
+    const auto& data = layerData(layer);
+    if (!data.snapshotValid || data.snapshotEpoch != data.epoch) {
+        data.cachedSnapshot = snapshot(layer);
+        data.snapshotEpoch = data.epoch;
+        data.snapshotValid = true;
+    }
+    return data.cachedSnapshot;
+}
+
+
+DistanceView GraphAlgorithms::breadthFirstSearch(const CsrGraph& g, int start, SearchWorkspace& ws, int threads) {
+    ws.prepare(g.vertexCount());
+    DistanceView view(ws.distance, ws.order, g.vertexIds(), g.indexMap());
+    int s = g.indexOf(start);
+    if (s < 0) return view;
+
+    auto rowOf = [&g](int v) { return g.neighbors(v); };
+    frontierSearch(g.vertexCount(), g.edgeCount(), s, rowOf, ws, threads);
+    return view;
 }
 
-bool GraphAlgorithms::hasPath(int from, int to) {
-    if (!adjacencyList.count(from) || !adjacencyList.count(to)) return false;
-    auto dist = breadthFirstSearch(from);
-    return dist.count(to) > 0;
-}
\ No newline at end of file
+BatchDistances GraphAlgorithms::multiSourceBfs(const CsrGraph& g, const vector<int>& sources, SearchWorkspace& ws, int threads) {
+    ws.prepare(g.vertexCount());
+    BatchDistances result(sources, g.vertexCount(), g.vertexIds(), g.indexMap());
+    vector<int> dense(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i)
+        dense[i] = g.indexOf(sources[i]);
+
+    auto rowOf = [&g](int v) { return g.neighbors(v); };
+    multiSourceSearch(g.vertexCount(), g.edgeCount(), dense, rowOf, ws, threads, result);
+    return result;
+}
+
+DistanceView GraphAlgorithms::dijkstra(const CsrGraph& g, int start, SearchWorkspace& ws) {
+    ws.prepare(g.vertexCount());
+    DistanceView view(ws.distance, ws.order, g.vertexIds(), g.indexMap());
+    int s = g.indexOf(start);
+    if (s < 0) return view;
+
+    auto& dist = ws.distance;
+    auto& heap = ws.heap;
+    greater<pair<int, int>> later;
+    dist.set(s, 0);
+    heap.push_back({ 0, s });
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), later);
+        auto top = heap.back(); heap.pop_back();
+        int d = top.first, u = top.second;
+        if (d > dist.get(u)) continue;
+        ws.order.push_back(u);
+
+        for (int v : g.neighbors(u)) {
+            if (!dist.has(v) || d + 1 < dist.get(v)) {
+                dist.set(v, d + 1);
+                heap.push_back({ d + 1, v });
+                push_heap(heap.begin(), heap.end(), later);
+            }
+        }
+    }
+    return view;
+}
+
+ScoreView GraphAlgorithms::weightedDijkstra(const CsrGraph& g, int start, SearchWorkspace& ws) {
+    ws.prepare(g.vertexCount());
+    ScoreView view(ws.score, ws.order, g.vertexIds(), g.indexMap());
+    int s = g.indexOf(start);
+    if (s < 0) return view;
+
+    auto& dist = ws.score;
+    auto& heap = ws.weightedHeap;
+    greater<pair<double, int>> later;
+    dist.set(s, 0);
+    ws.order.push_back(s);
+    heap.push_back({ 0, s });
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), later);
+        auto top = heap.back(); heap.pop_back();
+        double d = top.first;
+        int u = top.second;
+        if (d > dist.get(u)) continue;
+
+        size_t e = g.edgeBegin(u);
+        for (int v : g.neighbors(u)) {
+            double dv = d + g.weight(e++);
+            if (!dist.has(v) || dv < dist.get(v)) {
+                if (!dist.has(v)) ws.order.push_back(v);
+                dist.set(v, dv);
+                heap.push_back({ dv, v });
+                push_heap(heap.begin(), heap.end(), later);
+            }
+        }
+    }
+    return view;
+}
+
+// Delta-stepping (Meyer & Sanders): vertices sit in buckets of width
+// delta by tentative distance. A bucket is drained by relaxing light
+// edges (weight <= delta) until it stays empty, then the heavy edges of
+// everything it settled are relaxed once. Relaxation requests are built
+// in parallel per chunk of the frontier and applied serially.
+static const size_t RelaxChunk = 256;
+
+ScoreView GraphAlgorithms::deltaStepping(const CsrGraph& g, int start, SearchWorkspace& ws, double delta, int threads) {
+    int n = g.vertexCount();
+    ws.prepare(n);
+    ScoreView view(ws.score, ws.order, g.vertexIds(), g.indexMap());
+    int s = g.indexOf(start);
+    if (s < 0) return view;
+
+    if (delta <= 0) {
+        double total = 0;
+        for (size_t e = 0; e < g.edgeCount(); ++e) total += g.weight(e);
+        delta = g.edgeCount() ? total / g.edgeCount() : 1.0;
+        if (delta <= 0) delta = 1.0;
+    }
+
+    auto& dist = ws.score;
+    auto& bucketOf = ws.distance;
+    auto& frontier = ws.reverseOrder;
+    auto& buckets = ws.buckets;
+    auto& settled = ws.settled;
+    for (auto& b : buckets) b.clear();
+
+    auto relax = [&](int v, double d) {
+        if (dist.has(v) && d >= dist.get(v)) return;
+        if (!dist.has(v)) ws.order.push_back(v);
+        dist.set(v, d);
+        int b = static_cast<int>(d / delta);
+        if (bucketOf.has(v) && bucketOf.get(v) == b) return;
+        if (b >= static_cast<int>(buckets.size())) buckets.resize(b + 1);
+        buckets[b].push_back(v);
+        bucketOf.set(v, b);
+        };
+
+    // Relaxes the light or heavy edges of `sources`; with several threads
+    // the requests are collected per chunk first.
+    bool serial = resolveThreads(threads) == 1;
+    auto expand = [&](const vector<int>& sources, bool light) {
+        if (serial) {
+            for (int u : sources) {
+                double du = dist.get(u);
+                size_t e = g.edgeBegin(u);
+                for (int v : g.neighbors(u)) {
+                    double w = g.weight(e++);
+                    if ((w <= delta) == light) relax(v, du + w);
+                }
+            }
+            return;
+        }
+        size_t chunks = (sources.size() + RelaxChunk - 1) / RelaxChunk;
+        if (ws.requests.size() < chunks) ws.requests.resize(chunks);
+        parallelFor(threads, sources.size(), RelaxChunk, [&](size_t begin, size_t end) {
+            auto& out = ws.requests[begin / RelaxChunk];
+            out.clear();
+            for (size_t i = begin; i < end; ++i) {
+                int u = sources[i];
+                double du = dist.get(u);
+                size_t e = g.edgeBegin(u);
+                for (int v : g.neighbors(u)) {
+                    double w = g.weight(e++);
+                    if ((w <= delta) != light) continue;
+                    if (!dist.has(v) || du + w < dist.get(v))
+                        out.push_back({ v, du + w });
+                }
+            }
+            });
+        for (size_t c = 0; c < chunks; ++c)
+            for (const auto& r : ws.requests[c])
+                relax(r.first, r.second);
+        };
+
+    relax(s, 0);
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        settled.clear();
+        while (!buckets[i].empty()) {
+            frontier.clear();
+            frontier.swap(buckets[i]);
+            size_t kept = 0;
+            for (int v : frontier) {
+                if (!bucketOf.has(v) || bucketOf.get(v) != static_cast<int>(i)) continue;
+                bucketOf.set(v, -1);
+                frontier[kept++] = v;
+                settled.push_back(v);
+            }
+            frontier.resize(kept);
+            expand(frontier, true);
+        }
+        expand(settled, false);
+    }
+    return view;
+}
+
+ScoreView GraphAlgorithms::computeDegreeCentrality(const CsrGraph& g, SearchWorkspace& ws) {
+    ws.prepare(g.vertexCount());
+    for (int v = 0; v < g.vertexCount(); ++v) {
+        ws.score.set(v, g.degree(v));
+        ws.order.push_back(v);
+    }
+    return ScoreView(ws.score, ws.order, g.vertexIds(), g.indexMap());
+}
+
+ScoreView GraphAlgorithms::betweennessCentrality(const CsrGraph& g, SearchWorkspace& ws, int samples,
+    int threads, unsigned seed) {
+    int n = g.vertexCount();
+    ws.prepare(n);
+    for (int v = 0; v < n; ++v) ws.order.push_back(v);
+
+    double scale;
+    auto sources = pickSources(ws.order, samples, seed, scale);
+    auto rowOf = [&g](int v) { return g.neighbors(v); };
+    auto scores = brandes(n, sources, rowOf, scale, threads);
+    for (int v = 0; v < n; ++v) ws.score.set(v, scores[v]);
+    return ScoreView(ws.score, ws.order, g.vertexIds(), g.indexMap());
+}
+
+vector<int> GraphAlgorithms::coreDecomposition(const CsrGraph& g, int threads) {
+    vector<int> core;
+    coreDecompose(g.vertexCount(), [&g](int v) { return g.neighbors(v); }, core, threads);
+    return core;
+}
+
+CountView GraphAlgorithms::coreNumbers(const CsrGraph& g, SearchWorkspace& ws, int threads) {
+    auto core = coreDecomposition(g, threads);
+    ws.prepare(g.vertexCount());
+    for (int v = 0; v < g.vertexCount(); ++v) {
+        ws.distance.set(v, core[v]);
+        ws.order.push_back(v);
+    }
+    return CountView(ws.distance, ws.order, g.vertexIds(), g.indexMap());
+}
+
+bool GraphAlgorithms::hasCycle(const CsrGraph& g) {
+    return undirectedCycle(g.vertexCount(), [&g](int v) { return g.neighbors(v); });
+}
+
+vector<int> GraphAlgorithms::stronglyConnectedComponents(const CsrGraph& g, int* count) {
+    int n = g.vertexCount();
+    const auto& offsets = g.offsetArray();
+    const auto& targets = g.targetArray();
+    vector<int> component(n, -1), index(n, -1), low(n);
+    vector<int> open;
+    // Explicit call stack of (vertex, next edge to look at).
+    vector<pair<int, int>> calls;
+    int counter = 0, found = 0;
+
+    for (int root = 0; root < n; ++root) {
+        if (index[root] >= 0) continue;
+        index[root] = low[root] = counter++;
+        open.push_back(root);
+        calls.push_back({ root, offsets[root] });
+        while (!calls.empty()) {
+            int v = calls.back().first;
+            if (calls.back().second < offsets[v + 1]) {
+                int u = targets[calls.back().second++];
+                if (index[u] < 0) {
+                    index[u] = low[u] = counter++;
+                    open.push_back(u);
+                    calls.push_back({ u, offsets[u] });
+                }
+                // Still unassigned means still on the open stack.
+                else if (component[u] < 0) {
+                    low[v] = min(low[v], index[u]);
+                }
+                continue;
+            }
+            calls.pop_back();
+            if (!calls.empty()) {
+                int caller = calls.back().first;
+                low[caller] = min(low[caller], low[v]);
+            }
+            if (low[v] != index[v]) continue;
+            int w;
+            do {
+                w = open.back();
+                open.pop_back();
+                component[w] = found;
+            } while (w != v);
+            ++found;
+        }
+    }
+    if (count) *count = found;
+    return component;
+}
+
+vector<vector<int>> GraphAlgorithms::findTriangles(const CsrGraph& g, int threads) {
+    ForwardGraph fg;
+    orientByDegree(g.vertexCount(), [&g](int v) { return g.neighbors(v); }, threads, fg);
+    return listForward(fg, [&g](int v) { return g.idOf(v); }, threads);
+}
+
+long long GraphAlgorithms::countTriangles(const CsrGraph& g, int threads) {
+    ForwardGraph fg;
+    orientByDegree(g.vertexCount(), [&g](int v) { return g.neighbors(v); }, threads, fg);
+    return countForward(fg, threads);
+}
+
+ScoreView GraphAlgorithms::triangleCounts(const CsrGraph& g, SearchWorkspace& ws, int threads) {
+    ForwardGraph fg;
+    orientByDegree(g.vertexCount(), [&g](int v) { return g.neighbors(v); }, threads, fg);
+    vector<long long> counts;
+    countForwardPerVertex(fg, threads, counts);
+
+    ws.prepare(g.vertexCount());
+    for (int v = 0; v < g.vertexCount(); ++v) {
+        if (!counts[v]) continue;
+        ws.score.set(v, static_cast<double>(counts[v]));
+        ws.order.push_back(v);
+    }
+    return ScoreView(ws.score, ws.order, g.vertexIds(), g.indexMap());
+}
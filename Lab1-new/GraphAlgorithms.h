@@ -5,28 +5,223 @@
 #include <vector>
 #include <set>
 #include <queue>
+#include <unordered_map>
+#include <memory>
+#include <future>
+#include "CsrGraph.h"
+#include "SearchWorkspace.h"
+#include "DisjointSets.h"
+#include "DistanceOracle.h"
 
 using namespace std;
 
+// Relationship layers the algorithms can run on. All is the union of the
+// typed layers (posts have no target and never enter any layer).
+enum class Layer {
+    Friendship,
+    Subscription,
+    Message,
+    All
+};
+
+const int LayerCount = 4;
+
+// Link-prediction scores for a candidate v of u, summed over their common
+// neighbors w: 1 (common neighbors), 1 / log deg(w) (Adamic-Adar) or
+// 1 / deg(w) (resource allocation).
+enum class LinkScore {
+    CommonNeighbors,
+    AdamicAdar,
+    ResourceAllocation
+};
+
+struct Recommendation {
+    int id;
+    double score;
+};
+
 class GraphAlgorithms {
 protected:
-    map<int, vector<int>> adjacencyList;
+    // Neighbor lists are indexed by dense vertex slot and hold slots, sorted;
+    // multiplicity is keyed by the external ID pair.
+    struct AdjacencyLayer {
+        vector<vector<int>> adjacency;
+        unordered_map<long long, int> multiplicity;
+        unsigned long long epoch = 0;
+        // Moves on every change to the layer's edges, parallel ones
+        // included; epoch only moves when the neighbor lists change.
+        unsigned long long revision = 0;
+        // Connected components, kept up to date on insertion and rebuilt
+        // lazily after removals; presentVertices counts non-empty rows.
+        DisjointSets components;
+        int presentVertices = 0;
+
+        mutable CsrGraph cachedSnapshot;
+        mutable unsigned long long snapshotEpoch = 0;
+        mutable bool snapshotValid = false;
+    };
+
+    AdjacencyLayer layers[LayerCount];
+    unsigned long long epoch = 0;
+
+    // External ID -> dense slot shared by all layers and every snapshot.
+    // Freed slots are reused. This is not Graph's numbering: buildGraph
+    // loads IDs that need not be vertices of any Graph, and Graph moves its
+    // last vertex into a removed one's slot, which would renumber the
+    // sorted neighbor lists of every layer.
+    unordered_map<int, int> layerSlotOf;
+    vector<int> layerSlotId;
+    vector<int> freeLayerSlots;
+
+    // Reused by every query on this instance; returned views borrow it.
+    SearchWorkspace workspace;
+    // Worker threads for parallel traversals; 0 uses every hardware thread.
+    // One by default: a single interactive query is too small to split.
+    int threadCount = 1;
+
+    // Optional landmark oracle over one layer. It is rebuilt off-thread
+    // when that layer's epoch moves; the old one answers meanwhile.
+    int oracleLandmarks = 0;
+    Layer oracleLayer = Layer::Friendship;
+    shared_ptr<const DistanceOracle> oracle;
+    future<shared_ptr<const DistanceOracle>> pendingOracle;
+
+    int slotFor(int id);
+    int findSlot(int id) const;
+    int slotCount() const { return static_cast<int>(layerSlotId.size()); }
+
+    AdjacencyLayer& layerData(Layer layer) { return layers[static_cast<int>(layer)]; }
+    const AdjacencyLayer& layerData(Layer layer) const { return layers[static_cast<int>(layer)]; }
+    const vector<vector<int>>& adjacencyOf(Layer layer) const { return layerData(layer).adjacency; }
 
 public:
     GraphAlgorithms();
 
-    void buildGraph(const vector<pair<int, int>>& edges);
+    // Replaces the given layer; other layers are left untouched.
+    void buildGraph(const vector<pair<int, int>>& edges, Layer layer = Layer::All);
+
+    // Incremental maintenance: neighbor lists stay sorted and duplicate-free,
+    // parallel edges are tracked by multiplicity. Typed edges are mirrored
+    // into the All layer; removal drops the pair from every layer.
+    void addAdjacency(int a, int b, Layer layer = Layer::All);
+    void removeAdjacency(int a, int b);
+    void removeAdjacency(int a, int b, Layer layer);
+    // Generic edges live only in the All layer: lowers the pair's
+    // multiplicity by count and unlinks it once nothing else connects it.
+    void removeGenericAdjacency(int a, int b, int count);
+    void removeAdjacencyVertex(int id);
+    unsigned long long getEpoch() const { return epoch; }
+    unsigned long long getEpoch(Layer layer) const { return layerData(layer).epoch; }
+    unsigned long long getRevision(Layer layer) const { return layerData(layer).revision; }
+
+    void setThreadCount(int threads) { threadCount = threads > 0 ? threads : 0; }
+    int getThreadCount() const { return threadCount; }
+
+    // Views stay valid until the next query or mutation on this instance.
+    // breadthFirstSearch is the parallel direction-optimizing traversal.
+    DistanceView breadthFirstSearch(int start, Layer layer = Layer::All);
+    // Multi-source BFS: hop counts from every source in shared traversals
+    // of 64 sources each. Unlike views, the result owns its rows.
+    BatchDistances multiSourceBfs(const vector<int>& sources, Layer layer = Layer::All);
+    // True when the layer holds exactly totalVertices vertices, start among
+    // them, and they form a single component.
+    bool isConnected(int start, int totalVertices, Layer layer = Layer::All);
+    // Union-find lookup: near O(1) until a removal splits a component.
+    bool inSameComponent(int a, int b, Layer layer = Layer::All);
+    // Components among the vertices that have an edge in the layer.
+    int componentCount(Layer layer = Layer::All);
+    DistanceView dijkstra(int start, Layer layer = Layer::All);
+    ScoreView computeDegreeCentrality(Layer layer = Layer::All);
+    // Brandes betweenness: shortest paths between other pairs that pass
+    // through each vertex, every pair counted once. Parallel over sources,
+    // each worker with its own dependency totals. samples = 0 is exact;
+    // otherwise that many random sources are drawn and scaled up by n / k.
+    ScoreView betweennessCentrality(Layer layer = Layer::All, int samples = 0, unsigned seed = 1);
+    // Half-width of a sampled betweenness estimate: every score is within
+    // it of the exact value with the given confidence (Hoeffding bound).
+    static double betweennessErrorBound(int vertices, int samples, double confidence = 0.95);
+    // Core number of every vertex: the largest k such that it lies in a
+    // subgraph where everyone has at least k neighbors. One thread runs the
+    // linear bucket algorithm, more run level-synchronous parallel peeling.
+    CountView coreNumbers(Layer layer = Layer::All);
+    bool hasCycle(Layer layer = Layer::All);
+    // Triangles by degree-ordered compact-forward intersection, parallel
+    // over vertices. Counting modes never build the triangle list.
+    vector<vector<int>> findTriangles(Layer layer = Layer::All);
+    long long countTriangles(Layer layer = Layer::All);
+    // Triangles through each vertex; vertices in none are left out.
+    ScoreView triangleCounts(Layer layer = Layer::All);
+    // Point-to-point queries use a bidirectional BFS that always grows the
+    // smaller frontier and stops at the level where the two searches meet.
+    bool hasPath(int from, int to, Layer layer = Layer::All);
+    int pathLength(int from, int to, Layer layer = Layer::All);
+    // Vertex IDs from `from` to `to` inclusive; empty when unreachable.
+    vector<int> shortestPath(int from, int to, Layer layer = Layer::All);
+
+    // Vertices two hops from id (id itself left out), each with the number
+    // of shared neighbors. O(sum of neighbor degrees); counts sit in the
+    // workspace, so nothing is allocated once it has grown.
+    CountView twoHopNeighbors(int id, Layer layer = Layer::Friendship);
+    // Top k vertices two hops from id that are not already its neighbors,
+    // best score first (ties to the lower ID); a bounded heap keeps k items.
+    vector<Recommendation> recommend(int id, int k, LinkScore score = LinkScore::AdamicAdar,
+        Layer layer = Layer::Friendship);
+    // recommend() for every vertex with an edge in the layer, in parallel;
+    // one (ID, top k) entry per vertex, in slot order.
+    vector<pair<int, vector<Recommendation>>> recommendAll(int k, LinkScore score = LinkScore::AdamicAdar,
+        Layer layer = Layer::Friendship);
+
+    // Landmark distance oracle with k landmarks; 0 turns it off.
+    void enableDistanceOracle(int landmarks, Layer layer = Layer::Friendship);
+    bool hasDistanceOracle() const { return oracleLandmarks > 0; }
+    Layer distanceOracleLayer() const { return oracleLayer; }
+    // O(k) bounds on the hop distance. Never exact while the oracle lags
+    // behind the layer; a rebuild is started instead.
+    DistanceEstimate estimateDistance(int a, int b);
+    // Blocks until the oracle matches the layer's current epoch.
+    void waitForDistanceOracle();
+
+    // Frozen snapshot of the current adjacency for read-only analytics.
+    CsrGraph snapshot(Layer layer = Layer::All) const;
+    // Cached snapshot, rebuilt only when the layer epoch has moved.
+    const CsrGraph& currentSnapshot(Layer layer = Layer::All) const;
 
-    map<int, int> breadthFirstSearch(int start);
-    bool isConnected(int start, int totalVertices);
-    map<int, int> dijkstra(int start);
-    map<int, double> computeDegreeCentrality();
-    bool hasCycle();
-    vector<vector<int>> findTriangles();
-    bool hasPath(int from, int to);
+    // Snapshot versions index by CSR vertex; views borrow both g and ws.
+    static DistanceView breadthFirstSearch(const CsrGraph& g, int start, SearchWorkspace& ws, int threads = 0);
+    static BatchDistances multiSourceBfs(const CsrGraph& g, const vector<int>& sources, SearchWorkspace& ws, int threads = 0);
+    static DistanceView dijkstra(const CsrGraph& g, int start, SearchWorkspace& ws);
+    // Binary-heap Dijkstra over g's edge weights (1 when unweighted).
+    static ScoreView weightedDijkstra(const CsrGraph& g, int start, SearchWorkspace& ws);
+    // Experimental: parallel delta-stepping, same results as weightedDijkstra.
+    // Slower than it on one thread; see the sssp benchmark before using it.
+    // delta <= 0 picks the mean edge weight.
+    static ScoreView deltaStepping(const CsrGraph& g, int start, SearchWorkspace& ws,
+        double delta = 0, int threads = 0);
+    static ScoreView computeDegreeCentrality(const CsrGraph& g, SearchWorkspace& ws);
+    static ScoreView betweennessCentrality(const CsrGraph& g, SearchWorkspace& ws, int samples = 0,
+        int threads = 0, unsigned seed = 1);
+    static CountView coreNumbers(const CsrGraph& g, SearchWorkspace& ws, int threads = 0);
+    // Core numbers indexed by CSR vertex.
+    static vector<int> coreDecomposition(const CsrGraph& g, int threads = 0);
+    static bool hasCycle(const CsrGraph& g);
+    // Tarjan's strongly connected components with an explicit stack, g read
+    // as directed (row v lists v's out-neighbors). component[v] numbers
+    // them in reverse topological order; count receives how many there are.
+    static vector<int> stronglyConnectedComponents(const CsrGraph& g, int* count = nullptr);
+    static vector<vector<int>> findTriangles(const CsrGraph& g, int threads = 0);
+    static long long countTriangles(const CsrGraph& g, int threads = 0);
+    static ScoreView triangleCounts(const CsrGraph& g, SearchWorkspace& ws, int threads = 0);
 
 private:
-    bool hasCycleUtil(int v, int parent, set<int>& visited);
+    void addToLayer(AdjacencyLayer& data, int a, int b);
+    // Picks up a finished rebuild and starts one if the layer has moved on.
+    void refreshDistanceOracle();
+    static void linkSlots(AdjacencyLayer& data, int sa, int sb);
+    static void unlinkSlots(AdjacencyLayer& data, int sa, int sb);
+    void lowerAllLayer(int a, int b, int sa, int sb, int count);
+    // Length of a shortest s-t path in slots (-1 if none); meetFrom/meetTo
+    // is the edge joining the forward and backward search trees.
+    int bidirectionalSearch(int s, int t, const vector<vector<int>>& adjacency, int& meetFrom, int& meetTo);
 };
 
 #endif // GRAPH_ALGORITHMS_H
\ No newline at end of file
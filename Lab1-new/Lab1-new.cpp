@@ -1,22 +1,37 @@
 #include "SocialNetwork.h"
 #include "Logger.h"
 #include "Menu.h"
+#include "Benchmark.h"
 #include "gtest/gtest.h"
 #include <string>
 
 int main(int argc, char** argv) {
-    Logger::get().init("socialnetwork.log", LogLevel::DEBUG, true);
-    LOG_INFO("Application started");
-
     bool runTests = false;
+    bool runBench = false;
+    string benchFilter;
     for (int i = 1; i < argc; ++i) {
         string arg = argv[i];
         if (arg == "--test") {
             runTests = true;
             break;
         }
+        if (arg == "--bench") {
+            runBench = true;
+            if (i + 1 < argc) benchFilter = argv[i + 1];
+            break;
+        }
     }
 
+    if (runBench) {
+        Logger::get().init("socialnetwork.log", LogLevel::WARN, false);
+        runBenchmarks(benchFilter);
+        Logger::get().shutdown();
+        return 0;
+    }
+
+    Logger::get().init("socialnetwork.log", LogLevel::DEBUG, true);
+    LOG_INFO("Application started");
+
     if (runTests) {
         LOG_INFO("Running unit tests");
         ::testing::InitGoogleTest(&argc, argv);
@@ -46,9 +46,17 @@ public:
         const char* fileName, int line);
 };
 
-#define LOG_DEBUG(msg) Logger::get().log(LogLevel::DEBUG, msg, __FILE__, __LINE__)
-#define LOG_INFO(msg)  Logger::get().log(LogLevel::INFO,  msg, __FILE__, __LINE__)
-#define LOG_WARN(msg)  Logger::get().log(LogLevel::WARN,  msg, __FILE__, __LINE__)
-#define LOG_ERROR(msg) Logger::get().log(LogLevel::ERROR, msg, __FILE__, __LINE__)
+// The message expression is only evaluated when the level is enabled, so
+// disabled debug logging costs no string building or allocation.
+#define LOG_AT(level, msg) \
+    do { \
+        if (Logger::get().isEnabled(level)) \
+            Logger::get().log(level, msg, __FILE__, __LINE__); \
+    } while (0)
+
+#define LOG_DEBUG(msg) LOG_AT(LogLevel::DEBUG, msg)
+#define LOG_INFO(msg)  LOG_AT(LogLevel::INFO,  msg)
+#define LOG_WARN(msg)  LOG_AT(LogLevel::WARN,  msg)
+#define LOG_ERROR(msg) LOG_AT(LogLevel::ERROR, msg)
 
 #endif // LOGGER_H
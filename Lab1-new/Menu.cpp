@@ -8,7 +8,7 @@
 using namespace std;
 
 void runMenu(SocialNetwork& net) {
-    int choice;
+    int choice = 0;
     do {
         cout << "\n--- MENU ---\n1. Add user\n2. Add friendship\n3. Add subscription\n4. Send message\n5. Add post"
             << "\n6. Show info\n7. Update bio\n8. Set birthday\n9. Set phone\n10. Set gender"
@@ -17,7 +17,8 @@ void runMenu(SocialNetwork& net) {
             << "\n19. Recommend users you may know\n20. Show most central users\n21. Check friendship cycles"
             << "\n22. Update last login time\n23. Generate random users\n24. Export graph to DOT format"
             << "\n25. Save social network info to text file\n26. View users by role\n27. View relationships by type"
-            << "\n28. Network overview(template walk)"
+            << "\n28. Network overview(template walk)\n29. How am I connected to user"
+            << "\n30. Analyze network structure"
             << "\n0. Exit\nChoice: ";
 
         cin >> choice;
@@ -230,15 +231,17 @@ void runMenu(SocialNetwork& net) {
             int startId;
             cout << "Enter your user ID: ";
             cin >> startId;
-            auto dist = net.shortestPathsFrom(startId);
-            if (dist.empty()) {
+            auto recommended = net.recommendFriends(startId, 10);
+            if (recommended.empty()) {
                 cout << "No recommendations found.\n";
                 LOG_INFO("No recommendations for user ID=" + to_string(startId));
             }
             else {
                 cout << "Recommended users you may known.\n";
-                for (auto it = dist.begin(); it != dist.end(); ++it) {
-                    cout << "User" << it->first << "connection distance:" << it->second << endl;
+                for (const auto& r : recommended) {
+                    User* u = net.getUser(r.id);
+                    cout << "User " << r.id << (u ? " (" + u->getName() + ")" : string())
+                        << " score: " << r.score << endl;
                 }
                 LOG_DEBUG("Displayed recommendations for ID=" + to_string(startId));
             }
@@ -248,16 +251,19 @@ void runMenu(SocialNetwork& net) {
 
         case 20: {
             LOG_INFO("User selected: Show most central users");
-            auto cent = net.userCentrality();
-            if (cent.empty()) {
-                LOG_WARN("Centrality computation: no users found.");
+            auto ranking = net.influenceRanking(10);
+            if (ranking.empty()) {
+                cout << "No subscriptions yet.\n";
+                LOG_WARN("Influence ranking: no subscriptions found.");
             }
             else {
-                cout << "User influence ranking\n";
-                for (auto it = cent.begin(); it != cent.end(); ++it) {
-                    cout << "User " << it->first << "-> centrality score: " << it->second << endl;
+                cout << "User influence ranking (PageRank over subscriptions)\n";
+                for (const auto& entry : ranking) {
+                    User* u = net.getUser(entry.first);
+                    cout << "User " << entry.first << (u ? " (" + u->getName() + ")" : string())
+                        << " -> influence: " << entry.second << endl;
                 }
-                LOG_DEBUG("Displayed user centrality scores");
+                LOG_DEBUG("Displayed user influence ranking");
             }
             break;
         }
@@ -272,7 +278,7 @@ void runMenu(SocialNetwork& net) {
             else {
                 cout << "Detected friend groups\n";
                 for (size_t i = 0; i < cycles.size(); ++i) {
-                    cout << "Group " << (i + 1) << ": (";
+                    cout << "Group " << (i + 1) << " (" << cycles[i].size() << " users): (";
                     for (size_t j = 0; j < cycles[i].size(); ++j) {
                         cout << cycles[i][j];
                         if (j < cycles[i].size() - 1) cout << ", ";
@@ -428,6 +434,31 @@ void runMenu(SocialNetwork& net) {
             LOG_DEBUG("Social graph exploration completed");
             break;
         }
+
+        case 29: {
+            LOG_INFO("User selected: Show connection path");
+            int id1, id2;
+            cout << "Your user ID: "; cin >> id1;
+            cout << "Target user ID: "; cin >> id2;
+            auto path = net.connectionPath(id1, id2);
+            if (path.empty()) {
+                cout << "You are not connected to user " << id2 << ".\n";
+                LOG_INFO("No connection path from " + to_string(id1) + " to " + to_string(id2));
+            }
+            else {
+                cout << "Connection (" << path.size() - 1 << " steps): ";
+                for (size_t i = 0; i < path.size(); ++i)
+                    cout << (i ? " -> " : "") << path[i];
+                cout << endl;
+                LOG_DEBUG("Displayed connection path of " + to_string(path.size()) + " users");
+            }
+            break;
+        }
+        case 30: {
+            LOG_INFO("User selected: Analyze network structure");
+            net.printStructure();
+            break;
+        }
         default:
             if (choice != 0)
                 LOG_WARN("Unknown menu choice: " + to_string(choice));
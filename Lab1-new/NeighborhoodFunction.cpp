@@ -0,0 +1,161 @@
+#include "NeighborhoodFunction.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "Parallel.h"
+#include "Simd.h"
+
+static const size_t VerticesPerChunk = 1024;
+// Upper limit on passes when maxHops is 0; any real graph stops long before.
+static const int PassLimit = 1000;
+
+// into[i] = max(into[i], from[i]) over m one-byte registers.
+static void registerMax(uint8_t* into, const uint8_t* from, size_t m) {
+    size_t i = 0;
+#if defined(SIMD_AVX2)
+    for (; i + 32 <= m; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(into + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(into + i), _mm256_max_epu8(a, b));
+    }
+#endif
+#if defined(SIMD_AVX2) || defined(SIMD_SSE2)
+    for (; i + 16 <= m; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(into + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(into + i), _mm_max_epu8(a, b));
+    }
+#endif
+    for (; i < m; ++i)
+        if (from[i] > into[i]) into[i] = from[i];
+}
+
+static uint64_t mixBits(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// HyperLogLog estimate from m registers, with linear counting while
+// registers are still mostly empty.
+static double estimate(const uint8_t* reg, int m, const double* inversePower) {
+    double sum = 0;
+    int zeros = 0;
+    for (int j = 0; j < m; ++j) {
+        sum += inversePower[reg[j]];
+        if (!reg[j]) ++zeros;
+    }
+    double alpha = m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709 : 0.7213 / (1 + 1.079 / m);
+    double e = alpha * m * m / sum;
+    if (e <= 2.5 * m && zeros > 0) e = m * log(static_cast<double>(m) / zeros);
+    return e;
+}
+
+NeighborhoodFunction NeighborhoodFunction::compute(const CsrGraph& g, int reachHops, int registersLog2,
+    int threads, int maxHops, unsigned seed) {
+    NeighborhoodFunction result;
+    result.ids = g.vertexIds();
+    result.index = g.indexMap();
+    result.reachHops = max(reachHops, 0);
+    int b = min(max(registersLog2, 4), 16);
+    int m = 1 << b;
+    result.registerCount = m;
+    int n = g.vertexCount();
+    result.reachAt.assign(n, 1.0);
+    if (n == 0) return result;
+
+    double inversePower[66];
+    for (int k = 0; k < 66; ++k) inversePower[k] = ldexp(1.0, -k);
+
+    // Pass 0: every counter holds its own vertex.
+    size_t stride = static_cast<size_t>(m);
+    vector<uint8_t> current(stride * n, 0), next(stride * n);
+    for (int v = 0; v < n; ++v) {
+        uint64_t h = mixBits(static_cast<uint64_t>(v) ^ (static_cast<uint64_t>(seed) << 32));
+        int reg = static_cast<int>(h >> (64 - b));
+        uint64_t rest = h << b;
+        int rank = 1;
+        while (rank <= 64 - b && !(rest & (uint64_t(1) << 63))) {
+            rest <<= 1;
+            ++rank;
+        }
+        current[stride * v + reg] = static_cast<uint8_t>(rank);
+    }
+    vector<double> perVertex(n);
+    size_t chunks = (static_cast<size_t>(n) + VerticesPerChunk - 1) / VerticesPerChunk;
+    vector<double> partial(chunks);
+    auto total = [&]() {
+        parallelFor(threads, n, VerticesPerChunk, [&](size_t begin, size_t end) {
+            double sum = 0;
+            for (size_t v = begin; v < end; ++v) {
+                perVertex[v] = estimate(&current[stride * v], m, inversePower);
+                sum += perVertex[v];
+            }
+            partial[begin / VerticesPerChunk] = sum;
+            });
+        double sum = 0;
+        for (double p : partial) sum += p;
+        return sum;
+    };
+    result.pairs.push_back(total());
+    if (result.reachHops == 0) result.reachAt = perVertex;
+
+    // changed[v]: v's counter moved in the last pass, so its neighbors
+    // must merge it again; counters that did not move are already merged.
+    vector<char> changed(n, 1), changedNext(n);
+    int limit = maxHops > 0 ? maxHops : PassLimit;
+    for (int pass = 1; pass <= limit; ++pass) {
+        parallelFor(threads, n, VerticesPerChunk, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                uint8_t* into = &next[stride * v];
+                const uint8_t* own = &current[stride * v];
+                memcpy(into, own, stride);
+                for (int u : g.neighbors(static_cast<int>(v)))
+                    if (changed[u]) registerMax(into, &current[stride * u], stride);
+                changedNext[v] = memcmp(into, own, stride) != 0;
+            }
+            });
+        current.swap(next);
+        changed.swap(changedNext);
+        bool moved = find(changed.begin(), changed.end(), 1) != changed.end();
+        if (!moved) {
+            if (pass <= result.reachHops) result.reachAt = perVertex;
+            break;
+        }
+        result.pairs.push_back(total());
+        if (pass == result.reachHops) result.reachAt = perVertex;
+    }
+    if (static_cast<int>(result.pairs.size()) <= result.reachHops) result.reachAt = perVertex;
+    return result;
+}
+
+double NeighborhoodFunction::reach(int id) const {
+    auto it = index.find(id);
+    return it != index.end() ? reachAt[it->second] : 0.0;
+}
+
+double NeighborhoodFunction::effectiveDiameter(double fraction) const {
+    if (pairs.size() < 2) return 0.0;
+    double target = fraction * pairs.back();
+    size_t t = 0;
+    while (t < pairs.size() && pairs[t] < target) ++t;
+    if (t == 0) return 0.0;
+    if (t == pairs.size()) return static_cast<double>(t - 1);
+    double step = pairs[t] - pairs[t - 1];
+    return (t - 1) + (step > 0 ? (target - pairs[t - 1]) / step : 1.0);
+}
+
+double NeighborhoodFunction::averageDistance() const {
+    if (pairs.size() < 2) return 0.0;
+    double weighted = 0;
+    for (size_t t = 1; t < pairs.size(); ++t)
+        weighted += t * max(pairs[t] - pairs[t - 1], 0.0);
+    double reachable = pairs.back() - pairs.front();
+    return reachable > 0 ? weighted / reachable : 0.0;
+}
+
+double NeighborhoodFunction::relativeError() const {
+    return registerCount ? 1.04 / sqrt(static_cast<double>(registerCount)) : 0.0;
+}
@@ -0,0 +1,46 @@
+#ifndef NEIGHBORHOOD_FUNCTION_H
+#define NEIGHBORHOOD_FUNCTION_H
+
+#include <vector>
+#include <unordered_map>
+#include "CsrGraph.h"
+using namespace std;
+
+// HyperANF: every vertex keeps a HyperLogLog counter of the vertices it
+// reaches. Pass t merges each counter with its neighbors' (a register-wise
+// max), so after t passes it counts the ball of radius t. Only neighbors
+// whose counters changed in the previous pass are merged again.
+class NeighborhoodFunction {
+private:
+    vector<int> ids;
+    unordered_map<int, int> index;
+    vector<double> reachAt;
+    vector<double> pairs;
+    int reachHops = 0;
+    int registerCount = 0;
+
+public:
+    NeighborhoodFunction() {}
+    // Runs until no counter changes, or maxHops passes when maxHops > 0.
+    // Per-vertex reach is recorded after reachHops passes; 2^registersLog2
+    // one-byte registers per vertex (4..16) trade memory for accuracy.
+    static NeighborhoodFunction compute(const CsrGraph& g, int reachHops = 2, int registersLog2 = 6,
+        int threads = 0, int maxHops = 0, unsigned seed = 1);
+
+    int hops() const { return reachHops; }
+    // Estimated vertices within hops() of an ID, itself included; 0 when absent.
+    double reach(int id) const;
+    // Same, indexed like the snapshot.
+    const vector<double>& reachByVertex() const { return reachAt; }
+    // neighborhood()[t]: estimated ordered pairs (x, y) with d(x, y) <= t,
+    // the n pairs x == y included. The last entry is where it stopped.
+    const vector<double>& neighborhood() const { return pairs; }
+    // Hops within which `fraction` of the reachable pairs lie, interpolated.
+    double effectiveDiameter(double fraction = 0.9) const;
+    // Mean distance over reachable pairs of distinct vertices.
+    double averageDistance() const;
+    // Standard error of each counter, relative: 1.04 / sqrt(registers).
+    double relativeError() const;
+};
+
+#endif // NEIGHBORHOOD_FUNCTION_H
@@ -0,0 +1,108 @@
+#include "PageRank.h"
+#include <algorithm>
+#include <cmath>
+#include "Parallel.h"
+
+static const size_t VerticesPerChunk = 4096;
+
+int PageRank::run(const CsrGraph& incoming, int threads, bool warm,
+    double damping, double tolerance, int maxIterations) {
+    int n = incoming.vertexCount();
+    iterationsRun = 0;
+    lastResidual = 0;
+
+    // Carry the previous ranks over by ID, then renormalize to 1.
+    vector<double> rank(n, n ? 1.0 / n : 0.0);
+    if (warm && !ranks.empty()) {
+        double total = 0;
+        for (int v = 0; v < n; ++v) {
+            auto it = index.find(incoming.idOf(v));
+            if (it != index.end()) rank[v] = ranks[it->second];
+            total += rank[v];
+        }
+        if (total > 0)
+            for (auto& r : rank) r /= total;
+    }
+    ids = incoming.vertexIds();
+    index = incoming.indexMap();
+    if (n == 0) {
+        ranks.clear();
+        return 0;
+    }
+
+    // Out-degrees are the in-rows read backwards.
+    vector<int> outDegree(n, 0);
+    for (int u : incoming.targetArray()) ++outDegree[u];
+
+    const int* offsets = incoming.offsetArray().data();
+    const int* sources = incoming.targetArray().data();
+    vector<double> share(n), next(n);
+    size_t chunks = (static_cast<size_t>(n) + VerticesPerChunk - 1) / VerticesPerChunk;
+    vector<double> partial(chunks);
+
+    while (iterationsRun < maxIterations) {
+        // share[u]: what u sends along each outgoing arc; dangling rank is pooled.
+        parallelFor(threads, n, VerticesPerChunk, [&](size_t begin, size_t end) {
+            double dangling = 0;
+            for (size_t u = begin; u < end; ++u) {
+                if (outDegree[u]) share[u] = rank[u] / outDegree[u];
+                else {
+                    share[u] = 0;
+                    dangling += rank[u];
+                }
+            }
+            partial[begin / VerticesPerChunk] = dangling;
+            });
+        double dangling = 0;
+        for (double d : partial) dangling += d;
+        double base = (1.0 - damping + damping * dangling) / n;
+
+        parallelFor(threads, n, VerticesPerChunk, [&](size_t begin, size_t end) {
+            double change = 0;
+            for (size_t v = begin; v < end; ++v) {
+                double sum = 0;
+                for (int e = offsets[v]; e < offsets[v + 1]; ++e)
+                    sum += share[sources[e]];
+                next[v] = base + damping * sum;
+                change += fabs(next[v] - rank[v]);
+            }
+            partial[begin / VerticesPerChunk] = change;
+            });
+        rank.swap(next);
+        ++iterationsRun;
+        lastResidual = 0;
+        for (double c : partial) lastResidual += c;
+        if (lastResidual < tolerance) break;
+    }
+    ranks.swap(rank);
+    return iterationsRun;
+}
+
+double PageRank::rankOf(int id) const {
+    auto it = index.find(id);
+    return it != index.end() ? ranks[it->second] : 0.0;
+}
+
+vector<pair<int, double>> PageRank::top(int k) const {
+    vector<pair<int, double>> result;
+    if (k <= 0) return result;
+    vector<int> order(ranks.size());
+    for (int v = 0; v < static_cast<int>(order.size()); ++v) order[v] = v;
+    size_t count = min(order.size(), static_cast<size_t>(k));
+    // Vertices are in ascending ID order, so the lower index is the lower ID.
+    partial_sort(order.begin(), order.begin() + count, order.end(), [this](int a, int b) {
+        return ranks[a] != ranks[b] ? ranks[a] > ranks[b] : a < b;
+        });
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        result.push_back({ ids[order[i]], ranks[order[i]] });
+    return result;
+}
+
+vector<pair<int, double>> PageRank::all() const {
+    vector<pair<int, double>> result;
+    result.reserve(ranks.size());
+    for (size_t v = 0; v < ranks.size(); ++v)
+        result.push_back({ ids[v], ranks[v] });
+    return result;
+}
@@ -0,0 +1,51 @@
+#ifndef PAGE_RANK_H
+#define PAGE_RANK_H
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include "CsrGraph.h"
+using namespace std;
+
+// PageRank over a directed graph given by its incoming arcs: neighbors(v)
+// of the CSR are the vertices linking to v. Each iteration pulls rank
+// along those arcs in parallel, so no two threads write the same entry.
+// Rank of vertices without outgoing arcs is spread evenly over all.
+class PageRank {
+private:
+    vector<int> ids;
+    unordered_map<int, int> index;
+    vector<double> ranks;
+    int iterationsRun = 0;
+    double lastResidual = 0;
+
+public:
+    static constexpr double DefaultDamping = 0.85;
+    // Stop once the L1 change of the rank vector falls below this.
+    static constexpr double DefaultTolerance = 1e-7;
+    static constexpr int DefaultMaxIterations = 200;
+
+    PageRank() {}
+
+    // Ranks g until the change drops below tolerance or maxIterations pass.
+    // When warm is set, vertices ranked by the previous run start from
+    // their old rank, which after a small change converges in a few
+    // iterations; new vertices start at 1/n. Returns the iteration count.
+    int run(const CsrGraph& incoming, int threads = 0, bool warm = true,
+        double damping = DefaultDamping, double tolerance = DefaultTolerance,
+        int maxIterations = DefaultMaxIterations);
+
+    bool empty() const { return ids.empty(); }
+    size_t size() const { return ids.size(); }
+    // Rank of an external ID; 0 when it was not in the graph.
+    double rankOf(int id) const;
+    // The k best (ID, rank) pairs, highest first, ties to the lower ID.
+    vector<pair<int, double>> top(int k) const;
+    // Every (ID, rank) pair, in ascending ID order.
+    vector<pair<int, double>> all() const;
+
+    int iterations() const { return iterationsRun; }
+    double residual() const { return lastResidual; }
+};
+
+#endif // PAGE_RANK_H
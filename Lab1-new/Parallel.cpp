@@ -0,0 +1,119 @@
+#include "Parallel.h"
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+int hardwareThreads() {
+    unsigned n = thread::hardware_concurrency();
+    return n ? static_cast<int>(n) : 1;
+}
+
+int resolveThreads(int requested) {
+    return requested > 0 ? requested : hardwareThreads();
+}
+
+namespace {
+
+// Workers that outlive a single parallelFor, so per-level and per-phase
+// loops do not pay thread start-up on every call. One job runs at a time.
+class WorkerPool {
+private:
+    mutex submitGuard;
+    mutex guard;
+    condition_variable wake, finished;
+    vector<thread> workers;
+    bool stopping = false;
+
+    // Current job; guarded by `guard` except for the chunk counter.
+    const function<void(size_t, size_t)>* body = nullptr;
+    size_t count = 0, grain = 1, chunks = 0;
+    atomic<size_t> nextChunk{ 0 };
+    unsigned long long generation = 0;
+    int wanted = 0, joined = 0, running = 0;
+
+    void drain() {
+        for (size_t c = nextChunk.fetch_add(1); c < chunks; c = nextChunk.fetch_add(1)) {
+            size_t begin = c * grain;
+            (*body)(begin, begin + grain < count ? begin + grain : count);
+        }
+    }
+
+    void work() {
+        unsigned long long seen = 0;
+        unique_lock<mutex> lock(guard);
+        for (;;) {
+            wake.wait(lock, [&] { return stopping || (generation != seen && joined < wanted); });
+            if (stopping) return;
+            seen = generation;
+            ++joined;
+            ++running;
+            lock.unlock();
+            drain();
+            lock.lock();
+            if (--running == 0) finished.notify_all();
+        }
+    }
+
+public:
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> hold(guard);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    // False when another job holds the pool (a nested or concurrent call);
+    // the caller then runs the loop itself.
+    bool run(int threads, size_t n, size_t g, const function<void(size_t, size_t)>& f) {
+        unique_lock<mutex> submit(submitGuard, try_to_lock);
+        if (!submit.owns_lock()) return false;
+        {
+            lock_guard<mutex> hold(guard);
+            while (static_cast<int>(workers.size()) < threads - 1)
+                workers.emplace_back([this] { work(); });
+            body = &f;
+            count = n;
+            grain = g;
+            chunks = (n + g - 1) / g;
+            nextChunk = 0;
+            wanted = threads - 1;
+            joined = 0;
+            ++generation;
+        }
+        wake.notify_all();
+        drain();
+        // Every chunk is taken: close the job to late workers and wait for
+        // the ones still inside body.
+        unique_lock<mutex> lock(guard);
+        wanted = joined;
+        finished.wait(lock, [this] { return running == 0; });
+        body = nullptr;
+        return true;
+    }
+};
+
+WorkerPool& workerPool() {
+    static WorkerPool pool;
+    return pool;
+}
+
+}
+
+void parallelFor(int threads, size_t count, size_t grain, const function<void(size_t, size_t)>& body) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+    size_t chunks = (count + grain - 1) / grain;
+    threads = resolveThreads(threads);
+    if (static_cast<size_t>(threads) > chunks) threads = static_cast<int>(chunks);
+    if (threads <= 1) {
+        body(0, count);
+        return;
+    }
+    if (workerPool().run(threads, count, grain, body)) return;
+    // Pool busy: same chunks, on this thread, so per-chunk results line up.
+    for (size_t begin = 0; begin < count; begin += grain)
+        body(begin, begin + grain < count ? begin + grain : count);
+}
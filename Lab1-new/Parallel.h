@@ -0,0 +1,57 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+// Number of hardware threads, at least 1.
+int hardwareThreads();
+
+// Resolves a requested thread count: 0 or less means all hardware threads.
+int resolveThreads(int requested);
+
+// Runs body(begin, end) over [0, count) in chunks of `grain` items handed
+// out dynamically to up to `threads` threads (the caller is one of them).
+// The other threads come from a persistent pool. Runs inline when a single
+// chunk covers the range, or when the pool is busy with another call
+// (nested loops, or a background rebuild).
+void parallelFor(int threads, size_t count, size_t grain, const function<void(size_t, size_t)>& body);
+
+// Scratch objects for parallelFor chunks: a chunk acquires one that no
+// running chunk holds and releases it when done, so at most one object
+// per thread is ever built.
+template <typename T>
+class ScratchPool {
+private:
+    vector<unique_ptr<T>> owned;
+    vector<T*> idle;
+    mutex guard;
+
+public:
+    // make() returns a new T*; it is only called when every object is taken.
+    template <typename Make>
+    T* acquire(Make make) {
+        lock_guard<mutex> hold(guard);
+        if (idle.empty()) {
+            owned.emplace_back(make());
+            idle.push_back(owned.back().get());
+        }
+        T* item = idle.back();
+        idle.pop_back();
+        return item;
+    }
+
+    void release(T* item) {
+        lock_guard<mutex> hold(guard);
+        idle.push_back(item);
+    }
+
+    // Every object built so far; read it only after the parallel loop.
+    const vector<unique_ptr<T>>& all() const { return owned; }
+};
+
+#endif // PARALLEL_H
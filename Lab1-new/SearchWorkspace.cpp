@@ -0,0 +1,29 @@
+#include "SearchWorkspace.h"
+
+void SearchWorkspace::prepare(size_t n) {
+    distance.resize(n);
+    distance.reset();
+    score.resize(n);
+    score.reset();
+    order.clear();
+    order.reserve(n);
+    reverseDistance.resize(n);
+    reverseDistance.reset();
+    parent.resize(n);
+    parent.reset();
+    reverseParent.resize(n);
+    reverseParent.reset();
+    reverseOrder.clear();
+    heap.clear();
+    weightedHeap.clear();
+}
+
+void AtomicBitmap::assign(size_t n) {
+    wordCount = (n + 63) / 64;
+    if (wordCount > capacity) {
+        bits.reset(new atomic<uint64_t>[wordCount]);
+        capacity = wordCount;
+    }
+    for (size_t w = 0; w < wordCount; ++w)
+        bits[w].store(0, memory_order_relaxed);
+}
@@ -0,0 +1,222 @@
+#ifndef SEARCH_WORKSPACE_H
+#define SEARCH_WORKSPACE_H
+
+#include <map>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <unordered_map>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+using namespace std;
+
+// Dense array whose entries are valid only when stamped with the current
+// epoch. reset() is O(1): it bumps the epoch instead of clearing the array.
+template <typename T>
+class StampedArray {
+private:
+    // Value and stamp side by side: a lookup touches one cache line.
+    struct Entry {
+        T value;
+        unsigned stamp;
+    };
+    vector<Entry> entries;
+    unsigned current = 1;
+
+public:
+    // Grows only, so a warmed-up buffer never reallocates.
+    void resize(size_t n) {
+        if (n > entries.size())
+            entries.resize(n, Entry{ T(), 0 });
+    }
+
+    void reset() {
+        if (++current == 0) {
+            for (auto& e : entries) e.stamp = 0;
+            current = 1;
+        }
+    }
+
+    size_t size() const { return entries.size(); }
+    bool has(int i) const { return entries[i].stamp == current; }
+    const T& get(int i) const { return entries[i].value; }
+    void set(int i, const T& value) {
+        entries[i].value = value;
+        entries[i].stamp = current;
+    }
+};
+
+// Read-only view of a dense result: members lists the dense indices that
+// hold a value, ids/index translate between dense indices and external IDs.
+// The view borrows the workspace buffers and is invalidated by the next
+// query that uses the same workspace.
+template <typename T>
+class ResultView {
+private:
+    const StampedArray<T>* values = nullptr;
+    const vector<int>* members = nullptr;
+    const vector<int>* ids = nullptr;
+    const unordered_map<int, int>* index = nullptr;
+
+    int denseOf(int id) const {
+        if (!index) return -1;
+        auto it = index->find(id);
+        if (it == index->end() || it->second >= static_cast<int>(values->size())) return -1;
+        return values->has(it->second) ? it->second : -1;
+    }
+
+public:
+    class iterator {
+        const ResultView* view;
+        const int* pos;
+    public:
+        iterator(const ResultView* view, const int* pos) : view(view), pos(pos) {}
+        pair<int, T> operator*() const { return { (*view->ids)[*pos], view->values->get(*pos) }; }
+        iterator& operator++() { ++pos; return *this; }
+        bool operator!=(const iterator& o) const { return pos != o.pos; }
+        bool operator==(const iterator& o) const { return pos == o.pos; }
+    };
+
+    ResultView() {}
+    ResultView(const StampedArray<T>& values, const vector<int>& members,
+        const vector<int>& ids, const unordered_map<int, int>& index)
+        : values(&values), members(&members), ids(&ids), index(&index) {}
+
+    size_t size() const { return members ? members->size() : 0; }
+    bool empty() const { return size() == 0; }
+    size_t count(int id) const { return denseOf(id) >= 0 ? 1 : 0; }
+
+    // Value for an external ID; T() when the ID has no value.
+    T operator[](int id) const {
+        int v = denseOf(id);
+        return v >= 0 ? values->get(v) : T();
+    }
+    T at(int id) const {
+        int v = denseOf(id);
+        if (v < 0) throw out_of_range("ResultView::at: no value for ID " + to_string(id));
+        return values->get(v);
+    }
+
+    // Dense-index access for callers that stay in index space.
+    const vector<int>& indices() const { static const vector<int> none; return members ? *members : none; }
+    const T& valueAt(int v) const { return values->get(v); }
+
+    iterator begin() const { return { this, members ? members->data() : nullptr }; }
+    iterator end() const { return { this, members ? members->data() + members->size() : nullptr }; }
+
+    map<int, T> toMap() const {
+        map<int, T> result;
+        for (auto entry : *this) result.insert(entry);
+        return result;
+    }
+};
+
+// Index of the lowest set bit; bits must be non-zero.
+inline int lowestSetBit(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// One bit per dense index, safe to set from several threads at once.
+class AtomicBitmap {
+private:
+    unique_ptr<atomic<uint64_t>[]> bits;
+    size_t wordCount = 0;
+    size_t capacity = 0;
+
+public:
+    // Covers n indices, all cleared. Grows only.
+    void assign(size_t n);
+
+    size_t words() const { return wordCount; }
+    atomic<uint64_t>& word(size_t w) { return bits[w]; }
+    uint64_t load(size_t w) const { return bits[w].load(memory_order_relaxed); }
+
+    bool test(int i) const { return (load(i >> 6) >> (i & 63)) & 1; }
+    // Sets bit i; true only for the caller that flipped it.
+    bool claim(int i) {
+        uint64_t mask = uint64_t(1) << (i & 63);
+        if (load(i >> 6) & mask) return false;
+        return !(bits[i >> 6].fetch_or(mask, memory_order_relaxed) & mask);
+    }
+
+    void swap(AtomicBitmap& other) {
+        bits.swap(other.bits);
+        std::swap(wordCount, other.wordCount);
+        std::swap(capacity, other.capacity);
+    }
+};
+
+using DistanceView = ResultView<int>;
+using ScoreView = ResultView<double>;
+using CountView = ResultView<int>;
+
+// Hop counts from a batch of sources: row(i) is a dense array for
+// sources[i], indexed like the searched graph, -1 where unreachable.
+// The rows are owned; only the ID mapping is borrowed from the graph.
+class BatchDistances {
+private:
+    vector<int> sourceIds;
+    vector<vector<int>> rows;
+    const vector<int>* ids = nullptr;
+    const unordered_map<int, int>* index = nullptr;
+
+public:
+    BatchDistances() {}
+    BatchDistances(const vector<int>& sources, size_t n,
+        const vector<int>& ids, const unordered_map<int, int>& index)
+        : sourceIds(sources), rows(sources.size(), vector<int>(n, -1)), ids(&ids), index(&index) {}
+
+    size_t sourceCount() const { return sourceIds.size(); }
+    int sourceId(size_t i) const { return sourceIds[i]; }
+    const vector<int>& row(size_t i) const { return rows[i]; }
+    vector<int>& row(size_t i) { return rows[i]; }
+    int idOf(int v) const { return (*ids)[v]; }
+
+    // Distance from sources[i] to an external ID; -1 when not reached.
+    int distance(size_t i, int id) const {
+        auto it = index->find(id);
+        if (it == index->end() || it->second >= static_cast<int>(rows[i].size())) return -1;
+        return rows[i][it->second];
+    }
+};
+
+// Scratch buffers reused across traversals, so repeated queries allocate
+// nothing once the buffers have grown to the graph size.
+class SearchWorkspace {
+public:
+    StampedArray<int> distance;
+    StampedArray<double> score;
+    vector<int> order;
+    // Second side of bidirectional searches, plus parents for both sides.
+    StampedArray<int> reverseDistance;
+    StampedArray<int> parent, reverseParent;
+    vector<int> reverseOrder;
+    // Delta-stepping buckets and per-chunk relaxation requests.
+    vector<vector<int>> buckets;
+    vector<vector<pair<int, double>>> requests;
+    vector<int> settled;
+    // Multi-source BFS: one bit per source for every vertex.
+    vector<uint64_t> seenLanes, visitLanes, nextLanes;
+    vector<pair<int, int>> heap;
+    vector<pair<double, int>> weightedHeap;
+    // Bounded top-k heap of (score, -ID) for ranking queries.
+    vector<pair<double, int>> ranked;
+    AtomicBitmap frontier, next, visited;
+
+    // Sizes the buffers for n dense indices and forgets the previous query.
+    void prepare(size_t n);
+};
+
+#endif // SEARCH_WORKSPACE_H
@@ -0,0 +1,137 @@
+#include "SetIntersection.h"
+#include <algorithm>
+#include "Simd.h"
+
+// Beyond this size ratio, galloping beats scanning the large array.
+static const size_t GallopRatio = 16;
+// Below this many items a block step costs more than it saves.
+static const size_t SimdMinimum = 16;
+
+// Output policy: either stores matches or only counts them.
+struct WriteMatches {
+    int* out;
+    size_t count = 0;
+    void add(int value) { out[count++] = value; }
+    // mask bit k set: block[k] is a match.
+    void addBlock(const int* block, unsigned mask) {
+        for (; mask; mask &= mask - 1) {
+            int k = 0;
+            while (!((mask >> k) & 1)) ++k;
+            out[count++] = block[k];
+        }
+    }
+};
+
+struct CountMatches {
+    size_t count = 0;
+    void add(int) { ++count; }
+    void addBlock(const int*, unsigned mask) {
+        for (; mask; mask &= mask - 1) ++count;
+    }
+};
+
+template <typename Sink>
+static void mergeScalar(const int* a, size_t na, const int* b, size_t nb, Sink& sink) {
+    size_t i = 0, j = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) ++i;
+        else if (b[j] < a[i]) ++j;
+        else {
+            sink.add(a[i]);
+            ++i; ++j;
+        }
+    }
+}
+
+// small must be the shorter array. Each lookup doubles its step from the
+// last match, then binary-searches the bracketed range.
+template <typename Sink>
+static void gallop(const int* small, size_t ns, const int* large, size_t nl, Sink& sink) {
+    size_t lo = 0;
+    for (size_t i = 0; i < ns && lo < nl; ++i) {
+        int x = small[i];
+        size_t step = 1, hi = lo;
+        while (hi < nl && large[hi] < x) {
+            lo = hi + 1;
+            hi += step;
+            step *= 2;
+        }
+        if (hi > nl) hi = nl;
+        lo = static_cast<size_t>(lower_bound(large + lo, large + hi, x) - large);
+        if (lo < nl && large[lo] == x) {
+            sink.add(x);
+            ++lo;
+        }
+    }
+}
+
+// Block intersection (Lemire et al.): compare a block of a against every
+// rotation of a block of b, then advance the block with the smaller last
+// item (both when equal). Leftovers go through the scalar merge.
+template <typename Sink>
+static void blockIntersect(const int* a, size_t na, const int* b, size_t nb, Sink& sink) {
+    size_t i = 0, j = 0;
+#if defined(SIMD_AVX2)
+    const size_t Width = 8;
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while (i + Width <= na && j + Width <= nb) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        __m256i eq = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; ++r) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+        }
+        sink.addBlock(a + i, static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(eq))));
+        int lastA = a[i + Width - 1], lastB = b[j + Width - 1];
+        if (lastA <= lastB) i += Width;
+        if (lastB <= lastA) j += Width;
+    }
+#elif defined(SIMD_SSE2)
+    const size_t Width = 4;
+    while (i + Width <= na && j + Width <= nb) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        __m128i eq = _mm_cmpeq_epi32(va, vb);
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+        sink.addBlock(a + i, static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(eq))));
+        int lastA = a[i + Width - 1], lastB = b[j + Width - 1];
+        if (lastA <= lastB) i += Width;
+        if (lastB <= lastA) j += Width;
+    }
+#endif
+    mergeScalar(a + i, na - i, b + j, nb - j, sink);
+}
+
+template <typename Sink>
+static void intersect(const int* a, size_t na, const int* b, size_t nb, IntersectMethod method, Sink& sink) {
+    if (na == 0 || nb == 0) return;
+    if (na > nb) {
+        swap(a, b);
+        swap(na, nb);
+    }
+    if (method == IntersectMethod::Auto) {
+        if (nb / na >= GallopRatio) method = IntersectMethod::Galloping;
+        else if (na >= SimdMinimum) method = IntersectMethod::Simd;
+        else method = IntersectMethod::Merge;
+    }
+    switch (method) {
+    case IntersectMethod::Galloping: gallop(a, na, b, nb, sink); break;
+    case IntersectMethod::Simd:      blockIntersect(a, na, b, nb, sink); break;
+    default:                         mergeScalar(a, na, b, nb, sink); break;
+    }
+}
+
+size_t intersectSorted(const int* a, size_t na, const int* b, size_t nb, int* out, IntersectMethod method) {
+    WriteMatches sink{ out };
+    intersect(a, na, b, nb, method, sink);
+    return sink.count;
+}
+
+size_t intersectCount(const int* a, size_t na, const int* b, size_t nb, IntersectMethod method) {
+    CountMatches sink;
+    intersect(a, na, b, nb, method, sink);
+    return sink.count;
+}
@@ -0,0 +1,24 @@
+#ifndef SET_INTERSECTION_H
+#define SET_INTERSECTION_H
+
+#include <cstddef>
+using namespace std;
+
+// Intersection of sorted, duplicate-free int arrays, shared by the
+// mutual-friend, common-subscription and triangle queries.
+enum class IntersectMethod {
+    Auto,       // pick by size ratio and the SIMD width compiled in
+    Merge,      // scalar two-pointer merge
+    Galloping,  // exponential search of the small array's items in the large one
+    Simd        // block compare (AVX2 or SSE2), scalar merge when neither is built
+};
+
+// Writes the common items to out (room for min(na, nb) items), ascending,
+// and returns how many there are.
+size_t intersectSorted(const int* a, size_t na, const int* b, size_t nb, int* out,
+    IntersectMethod method = IntersectMethod::Auto);
+// Same, without writing the items.
+size_t intersectCount(const int* a, size_t na, const int* b, size_t nb,
+    IntersectMethod method = IntersectMethod::Auto);
+
+#endif // SET_INTERSECTION_H
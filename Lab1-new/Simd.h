@@ -0,0 +1,26 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// Vector instruction set this build targets, chosen once for every kernel:
+// SIMD_AVX2 or SIMD_SSE2 is defined with its intrinsics included, or neither
+// for the scalar fallbacks.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIMD_SSE2
+#endif
+
+// "AVX2", "SSE2" or "scalar", for benchmark output.
+inline const char* simdKind() {
+#if defined(SIMD_AVX2)
+    return "AVX2";
+#elif defined(SIMD_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+#endif // SIMD_H
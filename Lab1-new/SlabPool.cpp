@@ -0,0 +1,39 @@
+#include "SlabPool.h"
+#include <new>
+
+static size_t roundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+SlabPool::SlabPool(size_t objectSize, size_t blocksPerSlab)
+    : blockSize(roundUp(objectSize < sizeof(void*) ? sizeof(void*) : objectSize, alignof(max_align_t))),
+    blocksPerSlab(blocksPerSlab ? blocksPerSlab : 1),
+    usedInSlab(0), freeList(nullptr), liveBlocks(0) {
+    usedInSlab = this->blocksPerSlab;
+}
+
+SlabPool::~SlabPool() {
+    for (char* slab : slabs)
+        ::operator delete(slab);
+}
+
+void* SlabPool::allocate() {
+    ++liveBlocks;
+    if (freeList) {
+        void* block = freeList;
+        freeList = *static_cast<void**>(block);
+        return block;
+    }
+    if (usedInSlab == blocksPerSlab) {
+        slabs.push_back(static_cast<char*>(::operator new(blockSize * blocksPerSlab)));
+        usedInSlab = 0;
+    }
+    return slabs.back() + blockSize * usedInSlab++;
+}
+
+void SlabPool::release(void* block) {
+    if (!block) return;
+    *static_cast<void**>(block) = freeList;
+    freeList = block;
+    --liveBlocks;
+}
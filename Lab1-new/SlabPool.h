@@ -0,0 +1,35 @@
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+// Fixed-size block allocator. Blocks are carved out of large slabs, so
+// addresses stay stable; released blocks are recycled through a free list
+// and every slab is returned to the heap at once when the pool dies.
+class SlabPool {
+private:
+    size_t blockSize;
+    size_t blocksPerSlab;
+    vector<char*> slabs;
+    size_t usedInSlab;
+    void* freeList;
+    size_t liveBlocks;
+
+public:
+    explicit SlabPool(size_t objectSize, size_t blocksPerSlab = 1024);
+    ~SlabPool();
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    void* allocate();
+    void release(void* block);
+
+    size_t getBlockSize() const { return blockSize; }
+    size_t slabCount() const { return slabs.size(); }
+    size_t liveCount() const { return liveBlocks; }
+};
+
+#endif // SLAB_POOL_H
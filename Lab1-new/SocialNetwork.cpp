@@ -1,8 +1,10 @@
 #include "SocialNetwork.h"
 #include "Logger.h"
+#include "SetIntersection.h"
 #include <iostream>
 #include <fstream>
 #include <set>
+#include <algorithm>
 #include <cstdlib>    
 #include <ctime>
 using namespace std;
@@ -12,11 +14,10 @@ void SocialNetwork::addUser(User* user) {
         LOG_ERROR("Attempted to add null user");
         return;
     }
-    if (users.find(user->getId()) != users.end()) {
+    if (vertexSlot(user->getId()) >= 0) {
         LOG_WARN("User with ID " + to_string(user->getId()) + " already exists.");
         return;
     }
-    users[user->getId()] = user;
     addVertex(user);
     LOG_INFO("Added user ID=" + to_string(user->getId()) + " name=" + user->getName());
 }
@@ -26,6 +27,11 @@ void SocialNetwork::removeUser(int userId) {
     removeVertex(userId);
 }
 
+User* SocialNetwork::lookupUser(int userId) const {
+    int slot = vertexSlot(userId);
+    return slot >= 0 ? dynamic_cast<User*>(slotVertex[slot]) : nullptr;
+}
+
 User* SocialNetwork::getUser(int userId) const {
     Vertex* v = getVertex(userId);
     if (!v) {
@@ -40,25 +46,79 @@ User* SocialNetwork::getUser(int userId) const {
     return u;
 }
 
+// Algorithm layer an edge belongs to; posts have no target and are skipped.
+static bool layerOf(const Edge* e, Layer& layer) {
+    switch (e->getKind()) {
+    case EdgeKind::Friendship:   layer = Layer::Friendship; return true;
+    case EdgeKind::Subscription: layer = Layer::Subscription; return true;
+    case EdgeKind::Message:      layer = Layer::Message; return true;
+    case EdgeKind::Post:         return false;
+    default:                     layer = Layer::All; return true;
+    }
+}
+
+bool SocialNetwork::addEdge(Edge* e) {
+    if (!e) return Graph::addEdge(e);
+    int from = e->getFrom(), to = e->getTo();
+    Layer layer;
+    bool linked = layerOf(e, layer);
+    if (!Graph::addEdge(e)) return false;
+    if (linked)
+        addAdjacency(from, to, layer);
+    return true;
+}
+
+void SocialNetwork::removeEdge(int from, int to) {
+    Graph::removeEdge(from, to);
+    removeAdjacency(from, to);
+}
+
+void SocialNetwork::removeEdge(int from, int to, EdgeKind kind) {
+    // Generic edges share the All layer with typed ones, so only their own
+    // count comes off the pair there.
+    size_t generic = 0;
+    if (kind == EdgeKind::Generic)
+        generic = countEdges(from, to, kind) + (from != to ? countEdges(to, from, kind) : 0);
+    Graph::removeEdge(from, to, kind);
+    switch (kind) {
+    case EdgeKind::Friendship:   removeAdjacency(from, to, Layer::Friendship); break;
+    case EdgeKind::Subscription: removeAdjacency(from, to, Layer::Subscription); break;
+    case EdgeKind::Message:      removeAdjacency(from, to, Layer::Message); break;
+    case EdgeKind::Post:         break;
+    default:                     removeGenericAdjacency(from, to, static_cast<int>(generic)); break;
+    }
+}
+
+void SocialNetwork::removeVertex(int id) {
+    Graph::removeVertex(id);
+    removeAdjacencyVertex(id);
+}
+
 void SocialNetwork::addFriendship(int userA, int userB) {
     if (!getUser(userA) || !getUser(userB)) {
         LOG_ERROR("Invalid friendship IDs: " + to_string(userA) + ", " + to_string(userB));
         return;
     }
-    addEdge(new Friendship(userA, userB));
-    addEdge(new Friendship(userB, userA));
+    if (hasEdge(userA, userB, EdgeKind::Friendship)) {
+        LOG_INFO("Users " + to_string(userA) + " and " + to_string(userB) + " are already friends");
+        return;
+    }
+    emplaceEdge<Friendship>(userA, userB);
+    emplaceEdge<Friendship>(userB, userA);
     LOG_INFO("Created friendship between " + to_string(userA) + " and " + to_string(userB));
 }
 
 void SocialNetwork::removeFriendship(int userA, int userB) {
     LOG_INFO("Removing friendship between users " + to_string(userA) + " and " + to_string(userB));
-    removeEdge(userA, userB);
-    removeEdge(userB, userA);
+    removeEdge(userA, userB, EdgeKind::Friendship);
 }
 
 void SocialNetwork::addSubscription(int followerId, int followeeId) {
     LOG_INFO("Adding subscription: " + to_string(followerId) + " -> " + to_string(followeeId));
-    addEdge(new Subscription(followerId, followeeId));
+    if (!emplaceEdge<Subscription>(followerId, followeeId)) {
+        LOG_ERROR("Cannot subscribe: user not found");
+        return;
+    }
 
     if (auto* f = dynamic_cast<RegularUser*>(getUser(followerId)))
         f->addFollowing();
@@ -71,7 +131,7 @@ void SocialNetwork::sendMessage(int senderId, int receiverId, const string& text
         LOG_ERROR("Cannot send message  user not found");
         return;
     }
-    addEdge(new Message(senderId, receiverId, text));
+    emplaceEdge<Message>(senderId, receiverId, text);
 
     if (auto* s = dynamic_cast<RegularUser*>(getUser(senderId)))
         s->sendMessage();
@@ -86,7 +146,7 @@ void SocialNetwork::addPost(int authorId, const string& content) {
         LOG_ERROR("Cannot add post  user not found: " + to_string(authorId));
         return;
     }
-    addEdge(new Post(authorId, content));
+    emplaceEdge<Post>(authorId, content);
     if (auto* u = dynamic_cast<RegularUser*>(getUser(authorId)))
         u->addPost();
     LOG_INFO("User " + to_string(authorId) + " posted: " + content);
@@ -105,35 +165,45 @@ vector<User*> SocialNetwork::getFriendsOfUser(int userId) {
 
 vector<User*> SocialNetwork::findMutualFriends(int userA, int userB) {
     LOG_INFO("Finding mutual friends between " + to_string(userA) + " and " + to_string(userB));
-    auto friendsA = getFriendsOfUser(userA);
-    auto friendsB = getFriendsOfUser(userB);
     vector<User*> mutual;
-    for (auto* ua : friendsA)
-        for (auto* ub : friendsB)
-            if (ua->getId() == ub->getId())
-                mutual.push_back(ua);
+    int sa = findSlot(userA), sb = findSlot(userB);
+    if (sa >= 0 && sb >= 0) {
+        // Friendship rows are sorted slot lists, ready for the intersection kernel.
+        const auto& rowA = adjacencyOf(Layer::Friendship)[sa];
+        const auto& rowB = adjacencyOf(Layer::Friendship)[sb];
+        vector<int> common(min(rowA.size(), rowB.size()));
+        common.resize(intersectSorted(rowA.data(), rowA.size(), rowB.data(), rowB.size(), common.data()));
+        for (int slot : common)
+            if (auto* u = getUser(layerSlotId[slot]))
+                mutual.push_back(u);
+    }
     LOG_DEBUG("Mutual friends found: " + to_string(mutual.size()));
     return mutual;
 }
 
 vector<User*> SocialNetwork::findCloseFriends(int userId) {
     LOG_INFO("Finding close friends for user ID=" + to_string(userId));
-    set<int> closeSet;
-    auto friends = getFriendsOfUser(userId);
-    for (auto* f : friends) {
-        for (auto* ff : getFriendsOfUser(f->getId())) {
-            if (ff->getId() != userId)
-                closeSet.insert(ff->getId());
-        }
-    }
+    auto candidates = closeFriendCounts(userId);
     vector<User*> result;
-    for (int id : closeSet)
-        if (auto* u = getUser(id))
+    result.reserve(candidates.size());
+    for (auto entry : candidates)
+        if (auto* u = lookupUser(entry.first))
             result.push_back(u);
     LOG_DEBUG("Close friends found: " + to_string(result.size()));
     return result;
 }
 
+CountView SocialNetwork::closeFriendCounts(int userId) {
+    return GraphAlgorithms::twoHopNeighbors(userId, Layer::Friendship);
+}
+
+vector<Recommendation> SocialNetwork::recommendFriends(int userId, int k, LinkScore score) {
+    LOG_INFO("Recommending up to " + to_string(k) + " users for user ID=" + to_string(userId));
+    auto result = GraphAlgorithms::recommend(userId, k, score, Layer::Friendship);
+    LOG_DEBUG("Recommendations found: " + to_string(result.size()));
+    return result;
+}
+
 vector<User*> SocialNetwork::findUsersByLocation(const string& location) {
     LOG_INFO("Searching users by location: " + location);
     vector<User*> result;
@@ -149,17 +219,21 @@ vector<User*> SocialNetwork::findUsersByLocation(const string& location) {
 
 vector<User*> SocialNetwork::findCommonSubscriptions(int userA, int userB) {
     LOG_INFO("Finding common subscriptions between " + to_string(userA) + " and " + to_string(userB));
-    set<int> subsA, subsB;
-    for (auto* e : getAllEdges()) {
-        if (auto* s = dynamic_cast<Subscription*>(e)) {
-            if (s->getFrom() == userA) subsA.insert(s->getTo());
-            if (s->getFrom() == userB) subsB.insert(s->getTo());
-        }
-    }
+    auto subscriptionsOf = [this](int userId) {
+        vector<int> subs;
+        for (auto* e : outEdgesOf(userId))
+            if (e->getKind() == EdgeKind::Subscription) subs.push_back(e->getTo());
+        sort(subs.begin(), subs.end());
+        subs.erase(unique(subs.begin(), subs.end()), subs.end());
+        return subs;
+        };
+    vector<int> subsA = subscriptionsOf(userA), subsB = subscriptionsOf(userB);
+    vector<int> common(min(subsA.size(), subsB.size()));
+    common.resize(intersectSorted(subsA.data(), subsA.size(), subsB.data(), subsB.size(), common.data()));
     vector<User*> res;
-    for (int id : subsA)
-        if (subsB.count(id) && getUser(id))
-            res.push_back(getUser(id));
+    for (int id : common)
+        if (auto* u = getUser(id))
+            res.push_back(u);
     LOG_DEBUG("Common subscriptions found: " + to_string(res.size()));
     return res;
 }
@@ -174,13 +248,12 @@ vector<Message*> SocialNetwork::getMessagesOfUser(int userId) const {
         return messages;
     }
 
-    for (auto* e : getAllEdges()) {
-        if (auto* m = dynamic_cast<Message*>(e)) {
-            if (m->getFrom() == userId || m->getTo() == userId) {
-                messages.push_back(m);
-            }
-        }
-    }
+    for (auto* e : outEdgesOf(userId))
+        if (e->getKind() == EdgeKind::Message)
+            messages.push_back(static_cast<Message*>(e));
+    for (auto* e : inEdgesOf(userId))
+        if (e->getKind() == EdgeKind::Message && e->getFrom() != userId)
+            messages.push_back(static_cast<Message*>(e));
 
     LOG_DEBUG("Messages found for user ID=" + to_string(userId) +
         ": " + to_string(messages.size()));
@@ -197,13 +270,9 @@ vector<Post*> SocialNetwork::getPostsOfUser(int userId) const {
         return posts;
     }
 
-    for (auto* e : getAllEdges()) {
-        if (auto* p = dynamic_cast<Post*>(e)) {
-            if (p->getFrom() == userId || p->getTo() == userId) {
-                posts.push_back(p);
-            }
-        }
-    }
+    for (auto* e : outEdgesOf(userId))
+        if (e->getKind() == EdgeKind::Post)
+            posts.push_back(static_cast<Post*>(e));
 
     LOG_DEBUG("Posts found for user ID=" + to_string(userId) +
         ": " + to_string(posts.size()));
@@ -211,55 +280,196 @@ vector<Post*> SocialNetwork::getPostsOfUser(int userId) const {
 }
 
 
-bool SocialNetwork::areConnected(int userA, int userB) {
+bool SocialNetwork::areConnected(int userA, int userB, Layer layer) {
     LOG_INFO("Checking if users " + to_string(userA) + " and " + to_string(userB) + " are connected");
-    vector<pair<int, int>> edgesList;
-    for (auto* e : getAllEdges())
-        edgesList.push_back({ e->getFrom(), e->getTo() });
-    buildGraph(edgesList);
-    bool connected = GraphAlgorithms::hasPath(userA, userB);
+    bool connected = GraphAlgorithms::inSameComponent(userA, userB, layer);
     LOG_DEBUG("Users " + to_string(userA) + " and " + to_string(userB) +
         (connected ? " are connected" : " are NOT connected"));
     return connected;
 }
 
-int SocialNetwork::distanceBetween(int userA, int userB) {
+int SocialNetwork::distanceBetween(int userA, int userB, Layer layer) {
     LOG_INFO("Calculating distance between " + to_string(userA) + " and " + to_string(userB));
-    auto dist = GraphAlgorithms::breadthFirstSearch(userA);
-    int result = dist.count(userB) ? dist[userB] : -1;
+    if (hasDistanceOracle() && layer == distanceOracleLayer()) {
+        auto estimate = estimateDistance(userA, userB);
+        if (estimate.exact) {
+            LOG_DEBUG("Distance answered by landmark oracle: " + to_string(estimate.upper));
+            return estimate.upper;
+        }
+    }
+    int result = GraphAlgorithms::pathLength(userA, userB, layer);
     LOG_DEBUG("Distance result: " + to_string(result));
     return result;
 }
 
-map<int, int> SocialNetwork::shortestPathsFrom(int startId) {
-    LOG_INFO("Computing shortest paths from user ID=" + to_string(startId));
-    vector<pair<int, int>> edgesList;
-    for (auto* e : getAllEdges())
-        edgesList.push_back({ e->getFrom(), e->getTo() });
-    buildGraph(edgesList);
-    return GraphAlgorithms::dijkstra(startId);
+vector<int> SocialNetwork::connectionPath(int userA, int userB, Layer layer) {
+    LOG_INFO("Looking up connection path from " + to_string(userA) + " to " + to_string(userB));
+    auto path = GraphAlgorithms::shortestPath(userA, userB, layer);
+    LOG_DEBUG("Connection path has " + to_string(path.size()) + " users");
+    return path;
+}
+
+double SocialNetwork::tieStrength(int userA, int userB) const {
+    double strength = 0;
+    if (hasEdge(userA, userB, EdgeKind::Friendship) || hasEdge(userB, userA, EdgeKind::Friendship))
+        strength += 1;
+    strength += countEdges(userA, userB, EdgeKind::Message) + countEdges(userB, userA, EdgeKind::Message);
+    bool follows = hasEdge(userA, userB, EdgeKind::Subscription);
+    bool followedBack = hasEdge(userB, userA, EdgeKind::Subscription);
+    strength += 0.5 * (follows + followedBack);
+    if (follows && followedBack) strength += 1;
+    return strength;
+}
+
+const CsrGraph& SocialNetwork::tieGraph() {
+    // Friendships, subscriptions and messages are all mirrored into the All
+    // layer, so its revision moves whenever a tie strength can change.
+    if (tieValid && tieEpoch == getRevision(Layer::All)) return tieSnapshot;
+
+    tieSnapshot = currentSnapshot(Layer::All);
+    vector<double> weights(tieSnapshot.edgeCount());
+    for (int v = 0; v < tieSnapshot.vertexCount(); ++v) {
+        size_t e = tieSnapshot.edgeBegin(v);
+        for (int u : tieSnapshot.neighbors(v)) {
+            // Plain edges without a typed relationship count as one tie.
+            double strength = tieStrength(tieSnapshot.idOf(v), tieSnapshot.idOf(u));
+            weights[e++] = strength > 0 ? 1.0 / strength : 1.0;
+        }
+    }
+    tieSnapshot.assignWeights(move(weights));
+    tieEpoch = getRevision(Layer::All);
+    tieValid = true;
+    LOG_DEBUG("Rebuilt tie-strength graph with " + to_string(tieSnapshot.edgeCount()) + " weighted edges");
+    return tieSnapshot;
 }
 
-map<int, double> SocialNetwork::userCentrality() {
+ScoreView SocialNetwork::shortestPathsFrom(int startId) {
+    LOG_INFO("Computing strongest-connection distances from user ID=" + to_string(startId));
+    return GraphAlgorithms::weightedDijkstra(tieGraph(), startId, workspace);
+}
+
+BatchDistances SocialNetwork::distancesFrom(const vector<int>& userIds, Layer layer) {
+    LOG_INFO("Computing hop distances from " + to_string(userIds.size()) + " users");
+    return GraphAlgorithms::multiSourceBfs(userIds, layer);
+}
+
+ScoreView SocialNetwork::userCentrality(Layer layer) {
     LOG_INFO("Computing user centrality for network");
-    vector<pair<int, int>> edgesList;
-    for (auto* e : getAllEdges())
-        edgesList.push_back({ e->getFrom(), e->getTo() });
-    buildGraph(edgesList);
-    return GraphAlgorithms::computeDegreeCentrality();
-}
-
-vector<vector<int>> SocialNetwork::detectFriendGroups() {
-    LOG_INFO("Detecting friend groups (triangles)");
-    vector<pair<int, int>> edgesList;
-    for (auto* e : getAllEdges())
-        edgesList.push_back({ e->getFrom(), e->getTo() });
-    buildGraph(edgesList);
-    auto result = GraphAlgorithms::findTriangles();
-    LOG_DEBUG("Detected " + to_string(result.size()) + " friend groups");
+    return GraphAlgorithms::computeDegreeCentrality(currentSnapshot(layer), workspace);
+}
+
+ScoreView SocialNetwork::userBetweenness(Layer layer, int samples) {
+    LOG_INFO(samples > 0 ? "Estimating user betweenness from " + to_string(samples) + " sampled users"
+        : string("Computing exact user betweenness"));
+    return GraphAlgorithms::betweennessCentrality(currentSnapshot(layer), workspace, samples, threadCount);
+}
+
+const CsrGraph& SocialNetwork::followerGraph() {
+    // The Subscription layer is undirected, so a reverse follow of an
+    // existing one only shows in its revision, not its epoch.
+    if (followerValid && followerEpoch == getRevision(Layer::Subscription)) return followerSnapshot;
+
+    // Arcs run followee -> follower, in the same slots as the layer
+    // snapshots; every subscription already has both ends in its layer.
+    const auto& subscriptions = getEdgesOfKind(EdgeKind::Subscription);
+    vector<pair<int, int>> arcs;
+    arcs.reserve(subscriptions.size());
+    for (auto* e : subscriptions) {
+        int followee = findSlot(e->getTo()), follower = findSlot(e->getFrom());
+        if (followee >= 0 && follower >= 0) arcs.push_back({ followee, follower });
+    }
+    followerSnapshot = CsrGraph::fromArcs(arcs, layerSlotId);
+    followerEpoch = getRevision(Layer::Subscription);
+    followerValid = true;
+    LOG_DEBUG("Rebuilt follower graph with " + to_string(followerSnapshot.edgeCount()) + " subscriptions");
+    return followerSnapshot;
+}
+
+vector<vector<int>> SocialNetwork::mutualFollowClusters() {
+    LOG_INFO("Finding mutual-follow clusters");
+    // Reversing every arc keeps the strong components, so the follower
+    // graph serves as is.
+    const auto& g = followerGraph();
+    int count = 0;
+    auto component = GraphAlgorithms::stronglyConnectedComponents(g, &count);
+    vector<vector<int>> clusters(count);
+    for (int v = 0; v < g.vertexCount(); ++v)
+        clusters[component[v]].push_back(g.idOf(v));
+    clusters.erase(remove_if(clusters.begin(), clusters.end(),
+        [](const vector<int>& c) { return c.size() < 2; }), clusters.end());
+    stable_sort(clusters.begin(), clusters.end(), [](const vector<int>& a, const vector<int>& b) {
+        return a.size() != b.size() ? a.size() > b.size() : a.front() < b.front();
+        });
+    LOG_DEBUG("Found " + to_string(clusters.size()) + " mutual-follow clusters");
+    return clusters;
+}
+
+const PageRank& SocialNetwork::currentInfluence() {
+    if (influenceValid && influenceEpoch == getRevision(Layer::Subscription)) return influence;
+    int iterations = influence.run(followerGraph(), threadCount, influenceValid);
+    influenceEpoch = getRevision(Layer::Subscription);
+    influenceValid = true;
+    LOG_DEBUG("PageRank converged in " + to_string(iterations) + " iterations, residual "
+        + to_string(influence.residual()));
+    return influence;
+}
+
+vector<pair<int, double>> SocialNetwork::influenceRanking(int k) {
+    LOG_INFO("Ranking users by influence (top " + to_string(k) + ")");
+    return currentInfluence().top(k);
+}
+
+double SocialNetwork::influenceOf(int userId) {
+    return currentInfluence().rankOf(userId);
+}
+
+const vector<int>& SocialNetwork::currentCores(Layer layer) {
+    if (coreValid && coreLayer == layer && coreEpoch == getEpoch(layer)) return coreValues;
+    coreValues = GraphAlgorithms::coreDecomposition(currentSnapshot(layer), threadCount);
+    coreLayer = layer;
+    coreEpoch = getEpoch(layer);
+    coreValid = true;
+    return coreValues;
+}
+
+CsrSubgraph SocialNetwork::coreSubgraph(int k, Layer layer) {
+    LOG_INFO("Extracting the " + to_string(k) + "-core");
+    const auto& cores = currentCores(layer);
+    CsrSubgraph core(currentSnapshot(layer), cores, k);
+    LOG_DEBUG("The " + to_string(k) + "-core has " + to_string(core.vertexCount()) + " users");
+    return core;
+}
+
+int SocialNetwork::maxCoreNumber(Layer layer) {
+    const auto& cores = currentCores(layer);
+    return cores.empty() ? 0 : *max_element(cores.begin(), cores.end());
+}
+
+NeighborhoodFunction SocialNetwork::reachStatistics(int hops, Layer layer, int maxHops) {
+    LOG_INFO("Estimating " + to_string(hops) + "-hop reach");
+    auto result = NeighborhoodFunction::compute(currentSnapshot(layer), hops, 6, threadCount, maxHops);
+    LOG_DEBUG("Neighborhood function settled after " + to_string(result.neighborhood().size() - 1) + " hops");
     return result;
 }
 
+Communities SocialNetwork::detectCommunities(CommunityMethod method, Layer layer) {
+    LOG_INFO(string("Detecting communities with ")
+        + (method == CommunityMethod::Louvain ? "Louvain" : "label propagation"));
+    auto result = Communities::detect(currentSnapshot(layer), method, threadCount);
+    LOG_DEBUG("Found " + to_string(result.count()) + " communities, modularity "
+        + to_string(result.modularity()));
+    return result;
+}
+
+vector<vector<int>> SocialNetwork::detectFriendGroups(Layer layer) {
+    LOG_INFO("Detecting friend groups (communities)");
+    auto groups = detectCommunities(CommunityMethod::Louvain, layer).groups();
+    // Communities are ordered by size, so the singletons sit at the end.
+    while (!groups.empty() && groups.back().size() < 2) groups.pop_back();
+    LOG_DEBUG("Detected " + to_string(groups.size()) + " friend groups");
+    return groups;
+}
+
 void SocialNetwork::generateRandomUsers(SocialNetwork& network, int n, bool withRelations) {
     LOG_INFO("Generating " + to_string(n) + " random users");
     srand(static_cast<unsigned>(time(0)));
@@ -273,29 +483,36 @@ void SocialNetwork::generateRandomUsers(SocialNetwork& network, int n, bool with
         "Kyiv", "Lviv", "Odesa", "Kharkiv", "Dnipro", "Vinnytsia", "Sumy"
     };
 
+    // Number after the existing users, so a second batch adds to the network.
+    int first = 0;
+    network.forEachVertex([&first](Vertex* v) { first = max(first, v->getId() + 1); });
+
     for (int i = 0; i < n; ++i) {
-        string name = names[rand() % names.size()] + to_string(i + 1);
+        string name = names[rand() % names.size()] + to_string(first + i + 1);
         string email = name + "@mail.com";
-        User* u = new User(i, name, email);
+        User* u = network.emplaceVertex<User>(first + i, name, email);
+        if (!u) {
+            LOG_WARN("Skipping user " + to_string(first + i) + ": ID already taken");
+            continue;
+        }
         u->updateLocation(locations[rand() % locations.size()]);
         u->setGender((rand() % 2 == 0) ? "Male" : "Female");
         u->setBirthday("199" + to_string(rand() % 10) + "-0" + to_string(rand() % 9 + 1) + "-1" + to_string(rand() % 9));
-        network.addVertex(u);
     }
 
     if (withRelations) {
         for (int i = 0; i < n * 1.5; ++i) {
-            int u1 = rand() % n;
-            int u2 = rand() % n;
-            int u3 = rand() % n;
-            int u4 = rand() % n;
-            int u5 = rand() % n;
-            int u6 = rand() % n;
-
-            if (u1 != u2) network.addEdge(new Friendship(u1, u2));
-            if (u3 != u4) network.addEdge(new Subscription(u3, u4));
-            network.addEdge(new Post(rand() % n, "post"));
-            if (u5 != u6) network.addEdge(new Message(u5, u6, "message"));
+            int u1 = first + rand() % n;
+            int u2 = first + rand() % n;
+            int u3 = first + rand() % n;
+            int u4 = first + rand() % n;
+            int u5 = first + rand() % n;
+            int u6 = first + rand() % n;
+
+            if (u1 != u2) network.emplaceEdge<Friendship>(u1, u2);
+            if (u3 != u4) network.emplaceEdge<Subscription>(u3, u4);
+            network.emplaceEdge<Post>(first + rand() % n, "post");
+            if (u5 != u6) network.emplaceEdge<Message>(u5, u6, "message");
         }
     }
 
@@ -324,20 +541,18 @@ void SocialNetwork::saveToTextFile(const string& filename) const {
     }
 
     file << "\nRELATIONSHIPS\n";
-    for (auto* e : getAllEdges()) {
-        if (auto* f = dynamic_cast<Friendship*>(e)) {
-            file << "Friendship: " << f->getFrom() << " <-> " << f->getTo() << "\n";
-        }
-        else if (auto* s = dynamic_cast<Subscription*>(e)) {
-            file << "Subscription: " << s->getFrom() << " -> " << s->getTo() << "\n";
-        }
-        else if (auto* m = dynamic_cast<Message*>(e)) {
-            file << "Message: " << m->getFrom() << " -> " << m->getTo()
-                << " : " << m->getText() << "\n";
-        }
-        else if (auto* p = dynamic_cast<Post*>(e)) {
-            file << "Post by User " << p->getFrom() << ": " << p->getContent() << "\n";
-        }
+    for (auto* f : getEdgesOfKind(EdgeKind::Friendship))
+        file << "Friendship: " << f->getFrom() << " <-> " << f->getTo() << "\n";
+    for (auto* s : getEdgesOfKind(EdgeKind::Subscription))
+        file << "Subscription: " << s->getFrom() << " -> " << s->getTo() << "\n";
+    for (auto* e : getEdgesOfKind(EdgeKind::Message)) {
+        auto* m = static_cast<Message*>(e);
+        file << "Message: " << m->getFrom() << " -> " << m->getTo()
+            << " : " << m->getText() << "\n";
+    }
+    for (auto* e : getEdgesOfKind(EdgeKind::Post)) {
+        auto* p = static_cast<Post*>(e);
+        file << "Post by User " << p->getFrom() << ": " << p->getContent() << "\n";
     }
 
     file.close();
@@ -366,24 +581,27 @@ void SocialNetwork::printStatistics() {
 
     cout << "\nNETWORK STATISTICS\n";
 
-    auto allUsers = getAllVertices();
-    auto allEdges = getAllEdges();
-
     LOG_DEBUG("Counting users by type");
-    int regularCount = getVerticesOfType<RegularUser>().size();
-    int premiumCount = getVerticesOfType<PremiumUser>().size();
+    int userCount = 0, regularCount = 0, premiumCount = 0;
+    forEachVertex([&](Vertex* v) {
+        ++userCount;
+        if (auto* r = dynamic_cast<RegularUser*>(v)) {
+            ++regularCount;
+            if (dynamic_cast<PremiumUser*>(r)) ++premiumCount;
+        }
+        });
 
     LOG_DEBUG("Counting edges by type");
-    int friendships = countType<Friendship>(allEdges);
-    int subs = countType<Subscription>(allEdges);
-    int messages = countType<Message>(allEdges);
-    int posts = countType<Post>(allEdges);
+    int friendships = countType<Friendship>();
+    int subs = countType<Subscription>();
+    int messages = countType<Message>();
+    int posts = countType<Post>();
 
-    cout << "Users total: " << allUsers.size() << endl;
+    cout << "Users total: " << userCount << endl;
     cout << "Regular users: " << regularCount << endl;
     cout << "Premium users: " << premiumCount << endl;
 
-    cout << "\nConnections total: " << allEdges.size() << endl;
+    cout << "\nConnections total: " << edgeCount() << endl;
     cout << "Friendships: " << friendships << endl;
     cout << "Subscriptions: " << subs << endl;
     cout << "Messages: " << messages << endl;
@@ -397,3 +615,15 @@ void SocialNetwork::printStatistics() {
         });
     LOG_INFO("Network statistics completed successfully");
 }
+
+void SocialNetwork::printStructure() {
+    LOG_INFO("Analyzing network structure");
+    cout << "\nNETWORK STRUCTURE\n";
+    cout << "Friend triangles: " << GraphAlgorithms::countTriangles(currentSnapshot(Layer::Friendship), threadCount) << endl;
+    cout << "Mutual-follow clusters: " << mutualFollowClusters().size() << endl;
+    int core = maxCoreNumber(Layer::Friendship);
+    cout << "Engaged core: " << coreSubgraph(core).vertexCount() << " users with " << core << "+ friends inside it" << endl;
+    auto reach = reachStatistics(2, Layer::Friendship, StructureMaxHops);
+    cout << "Effective friend diameter (approx.): " << reach.effectiveDiameter() << " hops" << endl;
+    LOG_INFO("Network structure analysis completed");
+}
@@ -4,20 +4,26 @@
 #include "Graph.h"
 #include "User.h"
 #include "GraphAlgorithms.h"
+#include "PageRank.h"
+#include "Communities.h"
+#include "NeighborhoodFunction.h"
 #include <vector>
 #include <string>
 #include <map>
 using namespace std;
 
 class SocialNetwork : public Graph, public GraphAlgorithms {
-private:
-    map<int, User*> users;
-
 public:
     void addUser(User* user);
     void removeUser(int userId);
     User* getUser(int userId) const;
 
+    // Keep the algorithm-side adjacency in sync with the edge list.
+    bool addEdge(Edge* e) override;
+    void removeEdge(int from, int to) override;
+    void removeEdge(int from, int to, EdgeKind kind) override;
+    void removeVertex(int id) override;
+
     void addFriendship(int userA, int userB);
     void removeFriendship(int userA, int userB);
 
@@ -27,17 +33,64 @@ public:
 
     vector<User*> getFriendsOfUser(int userId);
     vector<User*> findMutualFriends(int userA, int userB);
+    // Friends of friends (the user left out), in discovery order.
     vector<User*> findCloseFriends(int userId);
+    // Same candidates, each with the number of friends they share with userId.
+    CountView closeFriendCounts(int userId);
+    // Top k non-friends ranked by a link-prediction score over friendships.
+    vector<Recommendation> recommendFriends(int userId, int k = 10, LinkScore score = LinkScore::AdamicAdar);
     vector<User*> findUsersByLocation(const string& location);
     vector<User*> findCommonSubscriptions(int userA, int userB);
     vector<Message*> getMessagesOfUser(int userId) const;
     vector<Post*> getPostsOfUser(int userId) const;
 
-    bool areConnected(int userA, int userB);
-    int distanceBetween(int userA, int userB);
-    map<int, int> shortestPathsFrom(int startId);
-    map<int, double> userCentrality();
-    vector<vector<int>> detectFriendGroups();
+    bool areConnected(int userA, int userB, Layer layer = Layer::Friendship);
+    // Uses the distance oracle when it is enabled on this layer and its
+    // bounds meet; falls back to a bidirectional search otherwise.
+    int distanceBetween(int userA, int userB, Layer layer = Layer::Friendship);
+    // Chain of user IDs linking userA to userB; empty when they are not linked.
+    vector<int> connectionPath(int userA, int userB, Layer layer = Layer::Friendship);
+    // Strength of the tie between two users: 1 for a friendship, 1 per
+    // message either way, 0.5 per subscription plus 1 when it is mutual.
+    double tieStrength(int userA, int userB) const;
+    // All relationships, each edge weighted 1 / tieStrength; rebuilt only
+    // after a relationship changes.
+    const CsrGraph& tieGraph();
+
+    // Views borrow the network's search buffers: read them before the next query.
+    // Strongest-connection distances over tieGraph (Dijkstra).
+    ScoreView shortestPathsFrom(int startId);
+    // Hop counts from each of userIds, 64 users per shared traversal.
+    BatchDistances distancesFrom(const vector<int>& userIds, Layer layer = Layer::Friendship);
+    ScoreView userCentrality(Layer layer = Layer::All);
+    // Betweenness over the layer: high scores mark users who bridge groups.
+    // samples > 0 estimates from that many random users; see
+    // GraphAlgorithms::betweennessErrorBound for the error.
+    ScoreView userBetweenness(Layer layer = Layer::Friendship, int samples = 0);
+    // Who follows whom, as incoming arcs: neighbors(v) of the snapshot are
+    // v's followers. Rebuilt only after a subscription changes.
+    const CsrGraph& followerGraph();
+    // Users who all reach one another by following subscriptions, e.g.
+    // mutual follows or follow loops: groups of two or more, largest first,
+    // members ascending.
+    vector<vector<int>> mutualFollowClusters();
+    // PageRank over subscriptions, best k first. Reruns only after a
+    // subscription changes, warm-started from the previous ranking.
+    vector<pair<int, double>> influenceRanking(int k = 10);
+    double influenceOf(int userId);
+    // The k-core of the layer: users with core number >= k and the edges
+    // among them. Zero-copy; valid until the next mutation.
+    CsrSubgraph coreSubgraph(int k, Layer layer = Layer::Friendship);
+    // Largest k with a non-empty k-core (the layer's degeneracy).
+    int maxCoreNumber(Layer layer = Layer::Friendship);
+    // Partition of the users with an edge in the layer into communities.
+    Communities detectCommunities(CommunityMethod method = CommunityMethod::Louvain, Layer layer = Layer::Friendship);
+    // Member IDs of each community of two or more users, largest first.
+    vector<vector<int>> detectFriendGroups(Layer layer = Layer::Friendship);
+    // Approximate reach of every user within `hops` steps, plus how the
+    // number of connected pairs grows with distance (HyperANF). maxHops > 0
+    // caps the passes; 0 runs until the counters settle.
+    NeighborhoodFunction reachStatistics(int hops = 2, Layer layer = Layer::Friendship, int maxHops = 0);
 
     static void generateRandomUsers(SocialNetwork& network, int n, bool withRelations = true);
 
@@ -46,6 +99,37 @@ public:
 
     void printNetwork() const;
     void printStatistics();
+    // Whole-graph analyses (triangles, clusters, cores, diameter); costs
+    // passes over every edge, so it is kept apart from printStatistics.
+    void printStructure();
+
+private:
+    // HyperANF passes printStructure allows before reporting the diameter.
+    static const int StructureMaxHops = 16;
+
+    // getUser without the per-call logging, for bulk results.
+    User* lookupUser(int userId) const;
+
+    CsrGraph tieSnapshot;
+    unsigned long long tieEpoch = 0;
+    bool tieValid = false;
+
+    CsrGraph followerSnapshot;
+    unsigned long long followerEpoch = 0;
+    bool followerValid = false;
+
+    // Core numbers indexed like currentSnapshot(coreLayer).
+    vector<int> coreValues;
+    Layer coreLayer = Layer::Friendship;
+    unsigned long long coreEpoch = 0;
+    bool coreValid = false;
+    const vector<int>& currentCores(Layer layer);
+
+    PageRank influence;
+    unsigned long long influenceEpoch = 0;
+    bool influenceValid = false;
+    // Brings the ranking up to date with the current epoch.
+    const PageRank& currentInfluence();
 };
 
 #endif // SOCIALNETWORK_H
\ No newline at end of file
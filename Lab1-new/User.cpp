@@ -81,14 +81,14 @@ void PremiumUser::print() const {
     cout << "\n";
 }
 
-Friendship::Friendship(int f, int t) : Edge(f, t) {}
+Friendship::Friendship(int f, int t) : Edge(f, t, Kind) {}
 void Friendship::print() const { cout << "Friendship: " << from << " <-> " << to << endl; }
 
-Subscription::Subscription(int f, int t) : Edge(f, t) {}
+Subscription::Subscription(int f, int t) : Edge(f, t, Kind) {}
 void Subscription::print() const { cout << "Subscription: " << from << " -> " << to << endl; }
 
-Message::Message(int f, int t, string msg) : Edge(f, t), text(msg) {}
+Message::Message(int f, int t, string msg) : Edge(f, t, Kind), text(msg) {}
 void Message::print() const { cout << "Message: " << from << " -> " << to << " : " << text << endl; }
 
-Post::Post(int f, string c) : Edge(f, -1), content(c) {}
+Post::Post(int f, string c) : Edge(f, NoTarget, Kind), content(c) {}
 void Post::print() const { cout << "Post: " << from << " : " << content << endl; }
\ No newline at end of file
@@ -89,12 +89,16 @@ public:
 
 class Friendship : public Edge {
 public:
+    static constexpr EdgeKind Kind = EdgeKind::Friendship;
+
     Friendship(int f, int t);
     void print() const override;
 };
 
 class Subscription : public Edge {
 public:
+    static constexpr EdgeKind Kind = EdgeKind::Subscription;
+
     Subscription(int f, int t);
     void print() const override;
 };
@@ -102,6 +106,8 @@ public:
 class Message : public Edge {
     string text;
 public:
+    static constexpr EdgeKind Kind = EdgeKind::Message;
+
     Message(int f, int t, string msg);
     void print() const override;
     const string& getText() const { return text; }
@@ -110,6 +116,8 @@ public:
 class Post : public Edge {
     string content;
 public:
+    static constexpr EdgeKind Kind = EdgeKind::Post;
+
     Post(int f, string c);
     void print() const override;
     const string& getContent() const { return content; }
@@ -3,6 +3,8 @@
 #include "User.h"
 #include <fstream>
 #include <sstream>
+#include <set>
+#include <algorithm>
 using namespace std;
 
 class TestVertex : public Vertex {
@@ -91,6 +93,12 @@ TEST(GraphTest, TypeCastingEdges) {
     auto allEdges = g.getAllEdges();
     EXPECT_EQ(g.countType<Friendship>(allEdges), 1);
     EXPECT_EQ(g.countType<Subscription>(allEdges), 1);
+
+    // Generic-kind types still match every subclass.
+    g.addEdge(new TestEdge(2, 1));
+    allEdges = g.getAllEdges();
+    EXPECT_EQ(g.countType<Edge>(allEdges), 3);
+    EXPECT_EQ(g.countType<TestEdge>(allEdges), 1);
 }
 
 TEST(GraphTest, ExportToDot) {
@@ -192,4 +200,189 @@ TEST(GraphTest, DestructorCleanup) {
         g.addEdge(e1);
     }
     SUCCEED(); 
-}
\ No newline at end of file
+}
+
+TEST(GraphTest, AdjacencyIndexFollowsRemovals) {
+    Graph g;
+    for (int i = 1; i <= 3; ++i)
+        g.addVertex(new TestVertex(i));
+
+    g.addEdge(new TestEdge(1, 2));
+    g.addEdge(new TestEdge(2, 1));
+    g.addEdge(new TestEdge(3, 1));
+    g.addEdge(new TestEdge(2, 3));
+
+    EXPECT_EQ(g.outDegree(2), 2);
+    EXPECT_EQ(g.inDegree(1), 2);
+    auto incoming = g.getInNeighbors(1);
+    EXPECT_TRUE(find(incoming.begin(), incoming.end(), 3) != incoming.end());
+
+    g.removeEdge(1, 2);
+    EXPECT_TRUE(g.getNeighbors(1).empty());
+    EXPECT_EQ(g.getNeighbors(2), vector<int>({ 3 }));
+    EXPECT_EQ(g.inDegree(1), 1);
+
+    g.removeVertex(3);
+    EXPECT_TRUE(g.getNeighbors(2).empty());
+    EXPECT_EQ(g.inDegree(1), 0);
+    EXPECT_EQ(g.getAllEdges().size(), 0);
+}
+
+TEST(GraphTest, EdgesAreBucketedByKind) {
+    Graph g;
+    for (int i = 1; i <= 3; ++i)
+        g.addVertex(new TestVertex(i));
+
+    g.addEdge(new Friendship(1, 2));
+    g.addEdge(new Friendship(2, 1));
+    g.addEdge(new Subscription(1, 3));
+    g.addEdge(new Message(2, 3, "hi"));
+    g.addEdge(new TestEdge(3, 1));
+
+    EXPECT_EQ(g.getEdgesOfKind(EdgeKind::Friendship).size(), 2);
+    EXPECT_EQ(g.countType<Friendship>(), 2);
+    EXPECT_EQ(g.countType<Subscription>(), 1);
+    EXPECT_EQ(g.countType<Post>(), 0);
+    EXPECT_EQ(g.countEdges(EdgeKind::Generic), 1);
+    EXPECT_EQ(g.edgeCount(), 5);
+    EXPECT_EQ(g.getEdgesOfType<TestEdge>().size(), 1);
+
+    g.removeEdge(1, 2);
+    EXPECT_EQ(g.countType<Friendship>(), 0);
+    EXPECT_EQ(g.edgeCount(), 3);
+
+    g.removeVertex(3);
+    EXPECT_EQ(g.edgeCount(), 0);
+    EXPECT_TRUE(g.getEdgesOfType<Message>().empty());
+}
+
+TEST(GraphTest, SlabPoolRecyclesBlocks) {
+    SlabPool pool(sizeof(TestEdge), 4);
+    vector<void*> blocks;
+    for (int i = 0; i < 6; ++i)
+        blocks.push_back(pool.allocate());
+    EXPECT_EQ(pool.slabCount(), 2);
+    EXPECT_EQ(pool.liveCount(), 6);
+
+    pool.release(blocks[1]);
+    EXPECT_EQ(pool.allocate(), blocks[1]) << "Released blocks should be reused first";
+    EXPECT_EQ(pool.slabCount(), 2);
+}
+
+TEST(GraphTest, EmplacedObjectsArePooled) {
+    Graph g;
+    auto* v1 = g.emplaceVertex<TestVertex>(1);
+    auto* v2 = g.emplaceVertex<TestVertex>(2);
+    EXPECT_EQ(g.getVertex(1), v1);
+
+    auto* f = g.emplaceEdge<Friendship>(1, 2);
+    auto* m = g.emplaceEdge<Message>(2, 1, "pooled");
+    EXPECT_EQ(g.getEdgesOfType<Friendship>(), vector<Friendship*>({ f }));
+    EXPECT_EQ(m->getText(), "pooled");
+
+    g.removeEdge(1, 2);
+    EXPECT_EQ(g.edgeCount(), 0);
+    g.addEdge(new TestEdge(1, 2));
+    g.removeVertex(2);
+    EXPECT_EQ(g.getVertex(1), v1);
+    EXPECT_EQ(g.getVertex(2), nullptr);
+    (void)v2;
+}
+
+TEST(GraphTest, EdgeIndexLookupAndKindRemoval) {
+    Graph g;
+    for (int i = 1; i <= 3; ++i)
+        g.addVertex(new TestVertex(i));
+
+    g.addEdge(new Friendship(1, 2));
+    g.addEdge(new Friendship(2, 1));
+    g.addEdge(new Subscription(1, 2));
+    g.addEdge(new Friendship(2, 3));
+
+    EXPECT_TRUE(g.hasEdge(1, 2, EdgeKind::Friendship));
+    EXPECT_TRUE(g.hasEdge(1, 2, EdgeKind::Subscription));
+    EXPECT_FALSE(g.hasEdge(2, 1, EdgeKind::Subscription));
+    EXPECT_FALSE(g.hasEdge(1, 3, EdgeKind::Friendship));
+
+    g.removeEdge(2, 1, EdgeKind::Friendship);
+    EXPECT_FALSE(g.hasEdge(1, 2, EdgeKind::Friendship));
+    EXPECT_FALSE(g.hasEdge(2, 1, EdgeKind::Friendship));
+    EXPECT_TRUE(g.hasEdge(1, 2, EdgeKind::Subscription)) << "Other kinds must survive";
+
+    auto friendships = g.getEdgesOfType<Friendship>();
+    ASSERT_EQ(friendships.size(), 1);
+    EXPECT_EQ(friendships[0]->getFrom(), 2);
+    EXPECT_EQ(friendships[0]->getTo(), 3);
+
+    g.removeVertex(2);
+    EXPECT_FALSE(g.hasEdge(2, 3, EdgeKind::Friendship));
+    EXPECT_EQ(g.edgeCount(), 0);
+}
+
+TEST(GraphTest, DenseSlotsSurviveVertexRemoval) {
+    Graph g;
+    for (int i = 10; i <= 40; i += 10)
+        g.addVertex(new TestVertex(i));
+    EXPECT_FALSE(g.addVertex(new TestVertex(20))) << "Duplicate IDs are rejected";
+
+    g.addEdge(new Friendship(40, 30));
+    g.removeVertex(10);
+
+    // The last vertex moved into the freed slot but keeps its ID and edges.
+    EXPECT_EQ(g.vertexCount(), 3);
+    EXPECT_EQ(g.vertexSlot(10), -1);
+    EXPECT_EQ(g.vertexSlot(40), 0);
+    EXPECT_EQ(g.vertexIdAt(0), 40);
+    ASSERT_NE(g.getVertex(40), nullptr);
+    EXPECT_EQ(g.getVertex(40)->getId(), 40);
+    EXPECT_EQ(g.getNeighbors(40), vector<int>{ 30 });
+    EXPECT_EQ(g.getInNeighbors(30), vector<int>{ 40 });
+}
+
+TEST(GraphTest, SwapAndPopRemovalKeepsListsConsistent) {
+    Graph g;
+    for (int i = 0; i < 8; ++i)
+        g.addVertex(new TestVertex(i));
+    // Vertex 0 is a hub with parallel edges, a self-loop and incoming edges.
+    multiset<pair<int, int>> model;
+    auto add = [&](int a, int b) { g.addEdge(new TestEdge(a, b)); model.insert({ a, b }); };
+    for (int round = 0; round < 3; ++round)
+        for (int v = 1; v < 8; ++v) add(0, v);
+    for (int v = 1; v < 8; ++v) add(v, 0);
+    add(0, 0);
+    add(3, 5);
+    add(5, 3);
+
+    auto check = [&]() {
+        for (int v = 0; v < 8; ++v) {
+            if (!g.getVertex(v)) continue;
+            vector<int> out, in;
+            for (auto& e : model) {
+                if (e.first == v) out.push_back(e.second);
+                if (e.second == v) in.push_back(e.first);
+            }
+            auto neighbors = g.getNeighbors(v), inNeighbors = g.getInNeighbors(v);
+            sort(neighbors.begin(), neighbors.end());
+            sort(inNeighbors.begin(), inNeighbors.end());
+            EXPECT_EQ(neighbors, out) << "out of " << v;
+            EXPECT_EQ(inNeighbors, in) << "in of " << v;
+        }
+        EXPECT_EQ(g.edgeCount(), model.size());
+    };
+
+    g.removeEdge(0, 4, EdgeKind::Generic);
+    model.erase({ 0, 4 });
+    model.erase({ 4, 0 });
+    check();
+
+    g.removeVertex(5);
+    for (auto it = model.begin(); it != model.end();)
+        it = it->first == 5 || it->second == 5 ? model.erase(it) : next(it);
+    check();
+
+    g.removeVertex(0);
+    for (auto it = model.begin(); it != model.end();)
+        it = it->first == 0 || it->second == 0 ? model.erase(it) : next(it);
+    check();
+    EXPECT_EQ(g.edgeCount(), 0);
+}
@@ -1,7 +1,14 @@
 #include "gtest/gtest.h"
 #include "SocialNetwork.h"
+#include "SetIntersection.h"
+#include <random>
 #include <algorithm>
 #include <vector>
+#include <cmath>
+#include <iterator>
+#include <queue>
+#include <set>
+#include <map>
 using namespace std;
 
 class SocialNetworkTest : public ::testing::Test {
@@ -247,3 +254,1051 @@ TEST_F(SocialNetworkTest, AddPost_ValidUser_StoredSuccessfully) {
         });
     EXPECT_TRUE(postExists) << "Post content should match the one added";
 }
+
+TEST_F(SocialNetworkTest, CsrSnapshotMatchesAdjacencyAlgorithms) {
+    ASSERT_NO_FATAL_FAILURE({
+        network.addFriendship(1, 2);
+        network.addFriendship(2, 3);
+        network.addFriendship(3, 1);
+        });
+    network.buildGraph({ { 1, 2 }, { 2, 3 }, { 3, 1 }, { 3, 4 } });
+
+    CsrGraph snap = network.snapshot();
+    EXPECT_EQ(snap.vertexCount(), 4);
+    EXPECT_EQ(snap.edgeCount(), 8);
+
+    SearchWorkspace ws;
+    EXPECT_EQ(GraphAlgorithms::breadthFirstSearch(snap, 1, ws).toMap(), network.breadthFirstSearch(1).toMap());
+    EXPECT_EQ(GraphAlgorithms::dijkstra(snap, 4, ws).toMap(), network.dijkstra(4).toMap());
+    EXPECT_EQ(GraphAlgorithms::computeDegreeCentrality(snap, ws).toMap(), network.computeDegreeCentrality().toMap());
+    EXPECT_TRUE(GraphAlgorithms::hasCycle(snap));
+    EXPECT_EQ(GraphAlgorithms::findTriangles(snap), vector<vector<int>>({ { 1, 2, 3 } }));
+
+    CsrGraph chain = CsrGraph::fromEdges({ { 1, 2 }, { 2, 3 } });
+    EXPECT_FALSE(GraphAlgorithms::hasCycle(chain));
+    EXPECT_TRUE(GraphAlgorithms::breadthFirstSearch(chain, 42, ws).empty());
+}
+
+TEST_F(SocialNetworkTest, SearchResultsReuseWorkspace) {
+    ASSERT_NO_FATAL_FAILURE({
+        network.addUser(new RegularUser(4, "Dave", "dave@mail.com"));
+        network.addUser(new RegularUser(5, "Eve", "eve@mail.com"));
+        network.addFriendship(1, 2);
+        network.addFriendship(2, 3);
+        network.addFriendship(4, 5);
+        });
+
+    auto fromOne = network.breadthFirstSearch(1, Layer::Friendship);
+    EXPECT_EQ(fromOne.size(), 3);
+    EXPECT_EQ(fromOne.at(3), 2);
+    EXPECT_EQ(fromOne.count(4), 0);
+    EXPECT_EQ(fromOne.toMap(), (map<int, int>{ { 1, 0 }, { 2, 1 }, { 3, 2 } }));
+
+    // The next query reuses the same buffers: stale entries must not leak.
+    auto fromFour = network.breadthFirstSearch(4, Layer::Friendship);
+    EXPECT_EQ(fromFour.size(), 2);
+    EXPECT_EQ(fromFour.count(1), 0);
+    EXPECT_EQ(fromFour[5], 1);
+    EXPECT_THROW(fromFour.at(2), out_of_range);
+
+    size_t visited = 0;
+    for (auto entry : fromFour) {
+        EXPECT_TRUE(entry.first == 4 || entry.first == 5);
+        ++visited;
+    }
+    EXPECT_EQ(visited, 2);
+    EXPECT_TRUE(network.breadthFirstSearch(999, Layer::Friendship).empty());
+}
+
+TEST_F(SocialNetworkTest, ParallelBfsMatchesSequentialBfs) {
+    // Dense enough that the search switches to bottom-up and back.
+    vector<pair<int, int>> edges;
+    unsigned seed = 12345;
+    auto nextRandom = [&seed]() { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 8) % 3000); };
+    for (int i = 0; i < 30000; ++i)
+        edges.push_back({ nextRandom(), nextRandom() });
+    edges.push_back({ 5000, 5001 });
+    network.buildGraph(edges);
+
+    CsrGraph snap = network.snapshot();
+    map<int, int> expected;
+    vector<int> queue = { snap.indexOf(edges[0].first) };
+    expected[snap.idOf(queue[0])] = 0;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int u = queue[head];
+        for (int v : snap.neighbors(u)) {
+            if (expected.count(snap.idOf(v))) continue;
+            expected[snap.idOf(v)] = expected[snap.idOf(u)] + 1;
+            queue.push_back(v);
+        }
+    }
+
+    SearchWorkspace ws;
+    for (int threads : { 1, 2, 4 }) {
+        network.setThreadCount(threads);
+        EXPECT_EQ(network.breadthFirstSearch(edges[0].first).toMap(), expected) << threads << " threads";
+        EXPECT_EQ(GraphAlgorithms::breadthFirstSearch(snap, edges[0].first, ws, threads).toMap(), expected);
+    }
+    EXPECT_EQ(network.breadthFirstSearch(5000).toMap(), (map<int, int>{ { 5000, 0 }, { 5001, 1 } }));
+}
+
+TEST_F(SocialNetworkTest, BidirectionalPathMatchesBfs) {
+    ASSERT_NO_FATAL_FAILURE({
+        network.addFriendship(1, 2);
+        network.addFriendship(2, 3);
+        });
+    EXPECT_EQ(network.connectionPath(1, 3), (vector<int>{ 1, 2, 3 }));
+    EXPECT_EQ(network.connectionPath(3, 3), vector<int>{ 3 });
+    EXPECT_TRUE(network.connectionPath(1, 999).empty());
+
+    vector<pair<int, int>> edges;
+    unsigned seed = 777;
+    auto nextRandom = [&seed]() { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 8) % 400); };
+    for (int i = 0; i < 600; ++i)
+        edges.push_back({ nextRandom(), nextRandom() });
+    network.buildGraph(edges, Layer::Message);
+    CsrGraph snap = network.snapshot(Layer::Message);
+
+    SearchWorkspace ws;
+    for (int source = 0; source < 400; source += 37) {
+        if (snap.indexOf(source) < 0) continue;
+        auto expected = GraphAlgorithms::breadthFirstSearch(snap, source, ws, 1).toMap();
+        for (int target = 0; target < 400; target += 13) {
+            auto path = network.shortestPath(source, target, Layer::Message);
+            int length = network.pathLength(source, target, Layer::Message);
+            if (!expected.count(target)) {
+                EXPECT_EQ(length, -1);
+                EXPECT_TRUE(path.empty());
+                continue;
+            }
+            EXPECT_EQ(length, expected[target]) << source << " -> " << target;
+            ASSERT_EQ(path.size(), expected[target] + 1);
+            EXPECT_EQ(path.front(), source);
+            EXPECT_EQ(path.back(), target);
+            for (size_t i = 1; i < path.size(); ++i) {
+                auto row = snap.neighbors(snap.indexOf(path[i - 1]));
+                EXPECT_TRUE(binary_search(row.begin(), row.end(), snap.indexOf(path[i])));
+            }
+        }
+    }
+}
+
+TEST(DisjointSetsTest, RefreshedSetsLeaveTheStaleList) {
+    // A path 0 - 1 - ... - 9; each round cuts and restores one edge.
+    const int n = 10;
+    vector<vector<int>> adjacency(n);
+    auto link = [&adjacency](int a, int b) { adjacency[a].push_back(b); adjacency[b].push_back(a); };
+    auto cut = [&adjacency](int a, int b) {
+        adjacency[a].erase(find(adjacency[a].begin(), adjacency[a].end(), b));
+        adjacency[b].erase(find(adjacency[b].begin(), adjacency[b].end(), a));
+    };
+    DisjointSets sets;
+    sets.resize(n);
+    for (int v = 0; v + 1 < n; ++v) {
+        link(v, v + 1);
+        sets.unite(v, v + 1);
+    }
+
+    for (int round = 0; round < 1000; ++round) {
+        int v = round % (n - 1);
+        cut(v, v + 1);
+        sets.invalidate(v);
+        sets.refresh(v, adjacency);
+        EXPECT_EQ(sets.staleCount(), 0);
+        EXPECT_NE(sets.find(0), sets.find(n - 1));
+        EXPECT_EQ(sets.count(), 2);
+        link(v, v + 1);
+        sets.unite(v, v + 1);
+    }
+    EXPECT_EQ(sets.count(), 1);
+}
+
+TEST_F(SocialNetworkTest, ComponentsFollowAdditionsAndRemovals) {
+    ASSERT_NO_FATAL_FAILURE({
+        network.addFriendship(1, 2);
+        network.addFriendship(2, 3);
+        });
+    EXPECT_TRUE(network.areConnected(1, 3));
+    EXPECT_EQ(network.componentCount(Layer::Friendship), 1);
+    EXPECT_TRUE(network.isConnected(1, 3, Layer::Friendship));
+
+    network.removeFriendship(2, 3);
+    EXPECT_FALSE(network.areConnected(1, 3)) << "The split component must be rebuilt";
+    EXPECT_FALSE(network.isConnected(1, 3, Layer::Friendship));
+    EXPECT_EQ(network.componentCount(Layer::Friendship), 1) << "User 3 has no friendships left";
+
+    // Random churn on a separate layer, checked against a plain search.
+    unsigned seed = 99;
+    auto nextRandom = [&seed](int n) { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 8) % n); };
+    for (int step = 0; step < 3000; ++step) {
+        int a = 100 + nextRandom(60), b = 100 + nextRandom(60);
+        int op = nextRandom(10);
+        if (op < 6) network.addAdjacency(a, b, Layer::Message);
+        else if (op < 9) network.removeAdjacency(a, b, Layer::Message);
+        else network.removeAdjacencyVertex(a);
+
+        if (step % 50 != 0) continue;
+        int c = 100 + nextRandom(60), d = 100 + nextRandom(60);
+        EXPECT_EQ(network.inSameComponent(c, d, Layer::Message), network.hasPath(c, d, Layer::Message))
+            << "step " << step << ": " << c << " - " << d;
+
+        CsrGraph snap = network.snapshot(Layer::Message);
+        SearchWorkspace ws;
+        vector<char> seen(snap.vertexCount(), 0);
+        int components = 0;
+        for (int v = 0; v < snap.vertexCount(); ++v) {
+            if (seen[v]) continue;
+            ++components;
+            for (int u : GraphAlgorithms::breadthFirstSearch(snap, snap.idOf(v), ws, 1).indices())
+                seen[u] = 1;
+        }
+        EXPECT_EQ(network.componentCount(Layer::Message), components) << "step " << step;
+    }
+}
+
+TEST_F(SocialNetworkTest, StrongestConnectionUsesTieStrength) {
+    ASSERT_NO_FATAL_FAILURE({
+        network.addFriendship(1, 2);
+        network.sendMessage(1, 2, "a");
+        network.sendMessage(2, 1, "b");
+        network.sendMessage(1, 2, "c");
+        network.addFriendship(2, 3);
+        network.sendMessage(3, 2, "d");
+        network.addFriendship(1, 3);
+        });
+    EXPECT_DOUBLE_EQ(network.tieStrength(1, 2), 4);
+    EXPECT_DOUBLE_EQ(network.tieStrength(2, 3), 2);
+
+    // 1 -> 2 -> 3 costs 1/4 + 1/2, less than the direct 1/1.
+    auto dist = network.shortestPathsFrom(1);
+    EXPECT_DOUBLE_EQ(dist[1], 0);
+    EXPECT_DOUBLE_EQ(dist[2], 0.25);
+    EXPECT_DOUBLE_EQ(dist[3], 0.75);
+
+    network.addSubscription(1, 3);
+    network.addSubscription(3, 1);
+    EXPECT_DOUBLE_EQ(network.tieStrength(1, 3), 3) << "Mutual subscriptions strengthen the tie";
+    EXPECT_NEAR(network.shortestPathsFrom(1)[3], 1.0 / 3, 1e-12);
+}
+
+TEST_F(SocialNetworkTest, DeltaSteppingMatchesDijkstra) {
+    vector<pair<int, int>> edges;
+    unsigned seed = 4242;
+    auto nextRandom = [&seed](int n) { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 8) % n); };
+    for (int i = 0; i < 4000; ++i)
+        edges.push_back({ nextRandom(800), nextRandom(800) });
+    CsrGraph g = CsrGraph::fromEdges(edges);
+    vector<double> weights(g.edgeCount());
+    for (int v = 0; v < g.vertexCount(); ++v) {
+        size_t e = g.edgeBegin(v);
+        for (int u : g.neighbors(v))
+            weights[e++] = ((g.idOf(v) + g.idOf(u)) % 17 + 1) / 8.0;
+    }
+    g.assignWeights(weights);
+
+    int source = g.idOf(0);
+    vector<double> expected(g.vertexCount(), -1);
+    priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> pq;
+    expected[0] = 0;
+    pq.push({ 0, 0 });
+    while (!pq.empty()) {
+        auto top = pq.top(); pq.pop();
+        if (top.first > expected[top.second]) continue;
+        size_t e = g.edgeBegin(top.second);
+        for (int v : g.neighbors(top.second)) {
+            double d = top.first + g.weight(e++);
+            if (expected[v] < 0 || d < expected[v]) {
+                expected[v] = d;
+                pq.push({ d, v });
+            }
+        }
+    }
+
+    SearchWorkspace ws;
+    auto dijkstra = GraphAlgorithms::weightedDijkstra(g, source, ws);
+    size_t reachedByDijkstra = 0;
+    for (int v = 0; v < g.vertexCount(); ++v) {
+        if (expected[v] < 0) continue;
+        ++reachedByDijkstra;
+        EXPECT_NEAR(dijkstra[g.idOf(v)], expected[v], 1e-9) << "vertex " << g.idOf(v);
+    }
+    EXPECT_EQ(dijkstra.size(), reachedByDijkstra);
+
+    for (double delta : { 0.0, 0.1, 1.0, 5.0 }) {
+        for (int threads : { 1, 3 }) {
+            auto dist = GraphAlgorithms::deltaStepping(g, source, ws, delta, threads);
+            size_t reached = 0;
+            for (int v = 0; v < g.vertexCount(); ++v) {
+                if (expected[v] < 0) {
+                    EXPECT_EQ(dist.count(g.idOf(v)), 0);
+                    continue;
+                }
+                ++reached;
+                EXPECT_NEAR(dist[g.idOf(v)], expected[v], 1e-9) << "delta " << delta << ", vertex " << g.idOf(v);
+            }
+            EXPECT_EQ(dist.size(), reached);
+        }
+    }
+}
+
+TEST_F(SocialNetworkTest, MultiSourceBfsMatchesSingleSourceBfs) {
+    vector<pair<int, int>> edges;
+    unsigned seed = 777;
+    auto nextRandom = [&seed]() { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 8) % 2000); };
+    for (int i = 0; i < 12000; ++i)
+        edges.push_back({ nextRandom(), nextRandom() });
+    edges.push_back({ 5000, 5001 });
+    network.buildGraph(edges);
+
+    // 70 sources span two batches; 999999 is unknown, 5000 sits apart.
+    vector<int> sources = { 5000, 999999 };
+    for (int i = 0; i < 68; ++i)
+        sources.push_back(edges[i].first);
+    sources.push_back(sources[2]);
+
+    CsrGraph snap = network.snapshot();
+    SearchWorkspace ws;
+    for (int threads : { 1, 3 }) {
+        network.setThreadCount(threads);
+        auto batch = network.multiSourceBfs(sources);
+        auto snapBatch = GraphAlgorithms::multiSourceBfs(snap, sources, ws, threads);
+        ASSERT_EQ(batch.sourceCount(), sources.size());
+        for (size_t i = 0; i < sources.size(); ++i) {
+            auto expected = network.breadthFirstSearch(sources[i]).toMap();
+            size_t reached = 0;
+            for (int v = 0; v < snap.vertexCount(); ++v) {
+                int id = snap.idOf(v);
+                int want = expected.count(id) ? expected[id] : -1;
+                EXPECT_EQ(batch.distance(i, id), want) << "source " << sources[i] << ", user " << id;
+                EXPECT_EQ(snapBatch.row(i)[v], want) << "source " << sources[i] << ", user " << id;
+                reached += want >= 0;
+            }
+            EXPECT_EQ(reached, expected.size());
+        }
+    }
+    EXPECT_EQ(network.distancesFrom({ 5000 }, Layer::All).distance(0, 5001), 1);
+    EXPECT_EQ(network.distancesFrom({ 999999 }, Layer::All).distance(0, 5001), -1);
+}
+
+TEST_F(SocialNetworkTest, LandmarkOracleBoundsDistances) {
+    vector<pair<int, int>> edges;
+    unsigned seed = 31337;
+    auto nextRandom = [&seed]() { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 8) % 400); };
+    for (int i = 0; i < 900; ++i)
+        edges.push_back({ nextRandom(), nextRandom() });
+    edges.push_back({ 5000, 5001 });
+    network.buildGraph(edges, Layer::Friendship);
+
+    network.enableDistanceOracle(6, Layer::Friendship);
+    network.waitForDistanceOracle();
+    size_t exact = 0, pairs = 0;
+    for (int a = 0; a < 400; a += 7) {
+        for (int b : { 1, 50, 123, 399, 5000, 999999 }) {
+            int truth = network.pathLength(a, b, Layer::Friendship);
+            auto estimate = network.estimateDistance(a, b);
+            ++pairs;
+            if (estimate.exact) {
+                ++exact;
+                EXPECT_EQ(estimate.upper, truth) << a << " -> " << b;
+            }
+            else if (truth >= 0) {
+                EXPECT_LE(estimate.lower, truth) << a << " -> " << b;
+                EXPECT_GE(estimate.upper, truth) << a << " -> " << b;
+            }
+            EXPECT_EQ(network.distanceBetween(a, b), truth) << a << " -> " << b;
+        }
+    }
+    EXPECT_GT(exact, pairs / 4) << "Landmarks should settle many pairs exactly";
+
+    // A mutation makes the oracle stale until the background rebuild lands.
+    network.addAdjacency(5001, 0, Layer::Friendship);
+    EXPECT_FALSE(network.estimateDistance(5000, 5001).exact);
+    network.waitForDistanceOracle();
+    auto joined = network.estimateDistance(5000, 0);
+    EXPECT_LE(joined.lower, 2);
+    EXPECT_GE(joined.upper, 2);
+    EXPECT_EQ(network.distanceBetween(5000, 0), 2);
+}
+
+TEST_F(SocialNetworkTest, TriangleModesAgreeWithBruteForce) {
+    // A hub joined to everyone skews the degrees, as in real networks.
+    vector<pair<int, int>> edges;
+    unsigned seed = 2024;
+    auto nextRandom = [&seed]() { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 8) % 300); };
+    for (int i = 0; i < 2500; ++i)
+        edges.push_back({ nextRandom(), nextRandom() });
+    for (int v = 1; v < 300; ++v)
+        edges.push_back({ 0, v });
+    network.buildGraph(edges);
+    CsrGraph snap = network.snapshot();
+
+    set<vector<int>> expected;
+    map<int, int> perVertex;
+    for (int u = 0; u < snap.vertexCount(); ++u)
+        for (int v : snap.neighbors(u))
+            for (int w : snap.neighbors(v))
+                if (u < v && v < w && binary_search(snap.neighbors(w).begin(), snap.neighbors(w).end(), u)) {
+                    vector<int> ids = { snap.idOf(u), snap.idOf(v), snap.idOf(w) };
+                    sort(ids.begin(), ids.end());
+                    expected.insert(ids);
+                    for (int id : ids) ++perVertex[id];
+                }
+    ASSERT_FALSE(expected.empty());
+
+    SearchWorkspace ws;
+    for (int threads : { 1, 3 }) {
+        network.setThreadCount(threads);
+        auto listed = GraphAlgorithms::findTriangles(snap, threads);
+        EXPECT_EQ(listed.size(), expected.size());
+        EXPECT_EQ(set<vector<int>>(listed.begin(), listed.end()), expected);
+        auto fromAdjacency = network.findTriangles();
+        EXPECT_EQ(set<vector<int>>(fromAdjacency.begin(), fromAdjacency.end()), expected);
+
+        EXPECT_EQ(GraphAlgorithms::countTriangles(snap, threads), static_cast<long long>(expected.size()));
+        EXPECT_EQ(network.countTriangles(), static_cast<long long>(expected.size()));
+
+        auto counts = GraphAlgorithms::triangleCounts(snap, ws, threads);
+        EXPECT_EQ(counts.size(), perVertex.size());
+        for (auto entry : perVertex)
+            EXPECT_EQ(counts[entry.first], entry.second) << "user " << entry.first;
+        EXPECT_EQ(network.triangleCounts().toMap().size(), perVertex.size());
+    }
+}
+
+TEST_F(SocialNetworkTest, IntersectionKernelMatchesStd) {
+    unsigned seed = 99;
+    auto nextRandom = [&seed](int n) { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 8) % n); };
+    auto sortedSet = [&](size_t size, int range) {
+        vector<int> v;
+        for (size_t i = 0; i < size; ++i) v.push_back(nextRandom(range));
+        sort(v.begin(), v.end());
+        v.erase(unique(v.begin(), v.end()), v.end());
+        return v;
+        };
+
+    for (size_t small : { 0, 1, 5, 17, 64, 300 }) {
+        for (size_t ratio : { 1, 3, 40, 500 }) {
+            vector<int> a = sortedSet(small, 4000), b = sortedSet(small * ratio + 3, 4000);
+            vector<int> expected;
+            set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(expected));
+            for (auto method : { IntersectMethod::Auto, IntersectMethod::Merge, IntersectMethod::Galloping, IntersectMethod::Simd }) {
+                vector<int> out(min(a.size(), b.size()));
+                out.resize(intersectSorted(b.data(), b.size(), a.data(), a.size(), out.data(), method));
+                EXPECT_EQ(out, expected) << "sizes " << a.size() << "/" << b.size() << ", method " << static_cast<int>(method);
+                EXPECT_EQ(intersectCount(a.data(), a.size(), b.data(), b.size(), method), expected.size());
+            }
+        }
+    }
+}
+
+TEST_F(SocialNetworkTest, MutualFriendsAndSubscriptionsUseSortedSets) {
+    auto* u4 = new RegularUser(4, "Dana", "dana@mail.com");
+    createdUsers.push_back(u4);
+    ASSERT_NO_FATAL_FAILURE({
+        network.addUser(u4);
+        network.addFriendship(1, 2);
+        network.addFriendship(3, 2);
+        network.addFriendship(1, 4);
+        network.addFriendship(3, 4);
+        network.sendMessage(1, 3, "hi");
+        network.addSubscription(1, 4);
+        network.addSubscription(3, 4);
+        network.addSubscription(1, 2);
+        });
+
+    vector<int> mutualIds;
+    for (auto* u : network.findMutualFriends(1, 3)) mutualIds.push_back(u->getId());
+    EXPECT_EQ(mutualIds, vector<int>({ 2, 4 })) << "Only friendships count, not messages";
+    EXPECT_TRUE(network.findMutualFriends(1, 999).empty());
+
+    auto common = network.findCommonSubscriptions(1, 3);
+    ASSERT_EQ(common.size(), 1);
+    EXPECT_EQ(common[0]->getId(), 4);
+}
+
+TEST_F(SocialNetworkTest, CloseFriendsCountSharedFriends) {
+    for (int id = 4; id <= 6; ++id) {
+        auto* u = new RegularUser(id, "User" + to_string(id), "user" + to_string(id) + "@mail.com");
+        createdUsers.push_back(u);
+        network.addUser(u);
+    }
+    ASSERT_NO_FATAL_FAILURE({
+        network.addFriendship(1, 2);
+        network.addFriendship(1, 3);
+        network.addFriendship(2, 3);
+        network.addFriendship(2, 4);
+        network.addFriendship(3, 4);
+        network.addFriendship(3, 5);
+        network.sendMessage(2, 6, "not a friendship");
+        });
+
+    auto counts = network.closeFriendCounts(1);
+    EXPECT_EQ(counts.toMap(), (map<int, int>{ { 2, 1 }, { 3, 1 }, { 4, 2 }, { 5, 1 } }));
+
+    vector<int> closeIds;
+    for (auto* u : network.findCloseFriends(1)) closeIds.push_back(u->getId());
+    sort(closeIds.begin(), closeIds.end());
+    EXPECT_EQ(closeIds, vector<int>({ 2, 3, 4, 5 }));
+    EXPECT_TRUE(network.findCloseFriends(999).empty());
+}
+
+TEST_F(SocialNetworkTest, RecommendationsRankNonFriends) {
+    // 1 knows 2, 3, 4. Candidate 10 shares 2 and 3; 11 shares only 4.
+    // Hub 4 is friends with everyone from 11 to 16.
+    network.buildGraph({ { 1, 2 }, { 1, 3 }, { 1, 4 }, { 2, 10 }, { 3, 10 }, { 4, 11 },
+        { 4, 12 }, { 4, 13 }, { 4, 14 }, { 4, 15 }, { 4, 16 }, { 2, 3 } }, Layer::Friendship);
+
+    auto common = network.recommend(1, 3, LinkScore::CommonNeighbors);
+    ASSERT_EQ(common.size(), 3);
+    EXPECT_EQ(common[0].id, 10);
+    EXPECT_DOUBLE_EQ(common[0].score, 2);
+    EXPECT_EQ(common[1].id, 11) << "Ties go to the lower ID";
+    EXPECT_EQ(common[2].id, 12);
+
+    auto resource = network.recommend(1, 2, LinkScore::ResourceAllocation);
+    ASSERT_EQ(resource.size(), 2);
+    EXPECT_EQ(resource[0].id, 10);
+    EXPECT_DOUBLE_EQ(resource[0].score, 1.0 / 3 + 1.0 / 3);
+    EXPECT_DOUBLE_EQ(resource[1].score, 1.0 / 7);
+
+    auto adamic = network.recommend(1, 100, LinkScore::AdamicAdar);
+    EXPECT_EQ(adamic.size(), 7) << "Friends 2, 3, 4 and the user never show up";
+    for (const auto& r : adamic)
+        EXPECT_TRUE(r.id >= 10) << r.id;
+    EXPECT_NEAR(adamic[0].score, 2 / log(3.0), 1e-12);
+    EXPECT_TRUE(network.recommend(999, 5).empty());
+
+    for (int threads : { 1, 3 }) {
+        network.setThreadCount(threads);
+        auto all = network.recommendAll(2, LinkScore::AdamicAdar);
+        EXPECT_EQ(all.size(), 11);
+        for (const auto& entry : all) {
+            auto single = network.recommend(entry.first, 2, LinkScore::AdamicAdar);
+            ASSERT_EQ(entry.second.size(), single.size()) << "user " << entry.first;
+            for (size_t i = 0; i < single.size(); ++i) {
+                EXPECT_EQ(entry.second[i].id, single[i].id);
+                EXPECT_DOUBLE_EQ(entry.second[i].score, single[i].score);
+            }
+        }
+    }
+}
+
+TEST_F(SocialNetworkTest, InfluenceRankingIsPageRankOverSubscriptions) {
+    for (int id = 4; id <= 6; ++id) {
+        auto* u = new RegularUser(id, "User" + to_string(id), "user" + to_string(id) + "@mail.com");
+        createdUsers.push_back(u);
+        network.addUser(u);
+    }
+    // Everyone follows 1; 1 follows 2 back; 6 follows nobody (dangling).
+    vector<pair<int, int>> follows = { { 2, 1 }, { 3, 1 }, { 4, 1 }, { 5, 1 }, { 6, 1 }, { 1, 2 }, { 4, 5 } };
+    ASSERT_NO_FATAL_FAILURE({
+        for (auto& f : follows) network.addSubscription(f.first, f.second);
+        network.addFriendship(3, 6);
+        });
+
+    // Reference: dense power iteration to a tight tolerance.
+    auto reference = [](const vector<pair<int, int>>& arcs, int n) {
+        vector<double> rank(n + 1, 1.0 / n), next(n + 1);
+        vector<int> out(n + 1, 0);
+        for (auto& a : arcs) ++out[a.first];
+        for (int it = 0; it < 500; ++it) {
+            double dangling = 0;
+            for (int v = 1; v <= n; ++v) if (!out[v]) dangling += rank[v];
+            fill(next.begin(), next.end(), (0.15 + 0.85 * dangling) / n);
+            for (auto& a : arcs) next[a.second] += 0.85 * rank[a.first] / out[a.first];
+            rank.swap(next);
+        }
+        return rank;
+    };
+
+    for (int threads : { 1, 3 }) {
+        network.setThreadCount(threads);
+        auto expected = reference(follows, 6);
+        auto top = network.influenceRanking(3);
+        ASSERT_EQ(top.size(), 3);
+        EXPECT_EQ(top[0].first, 1);
+        EXPECT_EQ(top[1].first, 2);
+        double total = 0;
+        for (int id = 1; id <= 6; ++id) {
+            EXPECT_NEAR(network.influenceOf(id), expected[id], 1e-6) << "user " << id;
+            total += network.influenceOf(id);
+        }
+        EXPECT_NEAR(total, 1.0, 1e-9);
+        EXPECT_EQ(network.influenceOf(999), 0);
+    }
+
+    // Friendships are not subscriptions.
+    EXPECT_EQ(network.followerGraph().edgeCount(), follows.size());
+
+    // A new subscription reruns warm and matches a cold run.
+    network.addSubscription(3, 5);
+    follows.push_back({ 3, 5 });
+    auto expected = reference(follows, 6);
+    for (int id = 1; id <= 6; ++id)
+        EXPECT_NEAR(network.influenceOf(id), expected[id], 1e-6) << "user " << id;
+    PageRank cold;
+    int coldIterations = cold.run(network.followerGraph(), 1);
+    PageRank warm;
+    warm.run(network.followerGraph(), 1);
+    EXPECT_EQ(warm.run(network.followerGraph(), 1), 1) << "A converged ranking needs one check";
+    EXPECT_GT(coldIterations, 1);
+}
+
+TEST_F(SocialNetworkTest, BetweennessFindsBridgeUsers) {
+    // Triangles {1, 2, 3} and {4, 5, 6} joined through 3 - 7 - 4.
+    vector<pair<int, int>> edges = { { 1, 2 }, { 2, 3 }, { 1, 3 }, { 4, 5 }, { 5, 6 }, { 4, 6 }, { 3, 7 }, { 7, 4 } };
+    network.buildGraph(edges, Layer::Friendship);
+    map<int, double> expected = { { 1, 0 }, { 2, 0 }, { 3, 8 }, { 4, 8 }, { 5, 0 }, { 6, 0 }, { 7, 9 } };
+
+    for (int threads : { 1, 3 }) {
+        network.setThreadCount(threads);
+        auto slots = network.betweennessCentrality(Layer::Friendship);
+        EXPECT_EQ(slots.size(), 7);
+        for (auto& e : expected) EXPECT_DOUBLE_EQ(slots[e.first], e.second) << "user " << e.first;
+
+        auto csr = network.userBetweenness();
+        for (auto& e : expected) EXPECT_DOUBLE_EQ(csr[e.first], e.second) << "user " << e.first;
+        auto allSources = network.userBetweenness(Layer::Friendship, 7);
+        EXPECT_DOUBLE_EQ(allSources[7], 9) << "Sampling every user is exact";
+    }
+
+    // Sampled scores are unbiased and stay inside the error bound.
+    EXPECT_EQ(GraphAlgorithms::betweennessErrorBound(7, 0), 0);
+    double bound = GraphAlgorithms::betweennessErrorBound(7, 3);
+    EXPECT_GT(bound, 0);
+    CsrGraph g = CsrGraph::fromEdges(edges);
+    SearchWorkspace ws;
+    double sum = 0;
+    const int runs = 400;
+    for (unsigned seed = 1; seed <= runs; ++seed) {
+        auto sampled = GraphAlgorithms::betweennessCentrality(g, ws, 3, 1, seed);
+        EXPECT_LE(fabs(sampled[7] - 9), bound);
+        sum += sampled[7];
+    }
+    EXPECT_NEAR(sum / runs, 9, 0.5);
+}
+
+TEST_F(SocialNetworkTest, CommunitiesPartitionFriendClusters) {
+    // Two 5-cliques (10..14, 20..24) joined by 14 - 20, and a separate triangle.
+    vector<pair<int, int>> edges = { { 14, 20 }, { 30, 31 }, { 31, 32 }, { 30, 32 } };
+    for (int base : { 10, 20 })
+        for (int a = base; a < base + 5; ++a)
+            for (int b = a + 1; b < base + 5; ++b) edges.push_back({ a, b });
+    network.buildGraph(edges, Layer::Friendship);
+
+    for (auto method : { CommunityMethod::Louvain, CommunityMethod::LabelPropagation }) {
+        for (int threads : { 1, 3 }) {
+            network.setThreadCount(threads);
+            auto communities = network.detectCommunities(method);
+            ASSERT_EQ(communities.count(), 3);
+            EXPECT_EQ(communities.communityOf(10), 0) << "Largest first, ties to the lower ID";
+            EXPECT_EQ(communities.communityOf(20), 1);
+            EXPECT_EQ(communities.communityOf(30), 2);
+            EXPECT_EQ(communities.communityOf(999), -1);
+            for (int id = 11; id < 15; ++id) EXPECT_EQ(communities.communityOf(id), 0);
+            EXPECT_EQ(communities.statsOf(0).size, 5);
+            EXPECT_EQ(communities.statsOf(0).internalEdges, 10);
+            EXPECT_EQ(communities.statsOf(0).boundaryEdges, 1);
+            EXPECT_EQ(communities.statsOf(2).boundaryEdges, 0);
+            EXPECT_GT(communities.modularity(), 0.5);
+        }
+    }
+
+    auto groups = network.detectFriendGroups();
+    ASSERT_EQ(groups.size(), 3);
+    EXPECT_EQ(groups[0], vector<int>({ 10, 11, 12, 13, 14 }));
+    EXPECT_EQ(groups[2], vector<int>({ 30, 31, 32 }));
+}
+
+TEST(CommunitiesTest, RecoversPlantedPartition) {
+    // 20 groups of 25: dense inside, a few random edges between groups.
+    mt19937 rng(5);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    vector<pair<int, int>> edges;
+    const int groups = 20, size = 25, n = groups * size;
+    for (int a = 0; a < n; ++a)
+        for (int b = a + 1; b < n; ++b)
+            if (unit(rng) < (a / size == b / size ? 0.5 : 0.002)) edges.push_back({ a, b });
+    CsrGraph g = CsrGraph::fromEdges(edges);
+
+    for (auto method : { CommunityMethod::Louvain, CommunityMethod::LabelPropagation }) {
+        auto communities = Communities::detect(g, method, 2);
+        int agree = 0, pairs = 0;
+        for (int a = 0; a < n; ++a)
+            for (int b = a + 1; b < n; ++b) {
+                bool same = communities.communityOf(a) == communities.communityOf(b);
+                agree += same == (a / size == b / size);
+                ++pairs;
+            }
+        EXPECT_GT(static_cast<double>(agree) / pairs, 0.99);
+        EXPECT_GT(communities.modularity(), 0.8);
+        long long internal = 0, boundary = 0;
+        for (size_t c = 0; c < communities.count(); ++c) {
+            internal += communities.statsOf(static_cast<int>(c)).internalEdges;
+            boundary += communities.statsOf(static_cast<int>(c)).boundaryEdges;
+        }
+        EXPECT_EQ(internal + boundary / 2, static_cast<long long>(g.edgeCount() / 2));
+    }
+}
+
+TEST_F(SocialNetworkTest, CoreNumbersAndCoreSubgraph) {
+    // Clique 1..4; 5 knows 1 and 2; 6 hangs off 5; 7 - 8 apart.
+    network.buildGraph({ { 1, 2 }, { 1, 3 }, { 1, 4 }, { 2, 3 }, { 2, 4 }, { 3, 4 },
+        { 5, 1 }, { 5, 2 }, { 6, 5 }, { 7, 8 } }, Layer::Friendship);
+    map<int, int> expected = { { 1, 3 }, { 2, 3 }, { 3, 3 }, { 4, 3 }, { 5, 2 }, { 6, 1 }, { 7, 1 }, { 8, 1 } };
+
+    for (int threads : { 1, 3 }) {
+        network.setThreadCount(threads);
+        auto cores = network.coreNumbers(Layer::Friendship);
+        EXPECT_EQ(cores.size(), 8);
+        for (auto& e : expected) EXPECT_EQ(cores[e.first], e.second) << "user " << e.first;
+
+        SearchWorkspace ws;
+        auto csr = GraphAlgorithms::coreNumbers(network.currentSnapshot(Layer::Friendship), ws, threads);
+        for (auto& e : expected) EXPECT_EQ(csr[e.first], e.second) << "user " << e.first;
+    }
+
+    EXPECT_EQ(network.maxCoreNumber(), 3);
+    auto core = network.coreSubgraph(3);
+    EXPECT_EQ(core.vertexCount(), 4);
+    EXPECT_EQ(core.vertexIds(), vector<int>({ 1, 2, 3, 4 }));
+    EXPECT_EQ(core.edgeCount(), 12);
+    EXPECT_FALSE(core.containsId(5));
+    const auto& g = core.graph();
+    vector<int> neighbors;
+    for (int u : core.neighbors(g.indexOf(1))) neighbors.push_back(g.idOf(u));
+    EXPECT_EQ(neighbors, vector<int>({ 2, 3, 4 })) << "5 is filtered out of 1's row";
+
+    auto two = network.coreSubgraph(2);
+    EXPECT_EQ(two.vertexCount(), 5);
+    EXPECT_EQ(two.degree(g.indexOf(5)), 2);
+    EXPECT_TRUE(network.coreSubgraph(4).empty());
+
+    network.removeAdjacency(3, 4, Layer::Friendship);
+    EXPECT_EQ(network.maxCoreNumber(), 2) << "Cores follow mutations";
+}
+
+TEST(CoreDecompositionTest, BucketsAndPeelingAgree) {
+    mt19937 rng(11);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    vector<pair<int, int>> edges;
+    auto skewed = [&]() { double x = unit(rng); return static_cast<int>(2000 * x * x); };
+    for (int i = 0; i < 12000; ++i) edges.push_back({ skewed(), skewed() });
+    CsrGraph g = CsrGraph::fromEdges(edges);
+
+    auto buckets = GraphAlgorithms::coreDecomposition(g, 1);
+    auto peeled = GraphAlgorithms::coreDecomposition(g, 4);
+    EXPECT_EQ(buckets, peeled);
+
+    // Inside the k-core everyone keeps at least k neighbors, and the
+    // (k + 1)-core leaves out every vertex with core number k.
+    int top = *max_element(buckets.begin(), buckets.end());
+    EXPECT_GT(top, 3);
+    for (int k : { 1, top / 2, top }) {
+        CsrSubgraph core(g, buckets, k);
+        for (int v = 0; v < g.vertexCount(); ++v)
+            if (core.contains(v)) {
+                EXPECT_GE(core.degree(v), k);
+            }
+        CsrSubgraph above(g, buckets, k + 1);
+        for (int v = 0; v < g.vertexCount(); ++v)
+            if (buckets[v] == k) {
+                EXPECT_FALSE(above.contains(v));
+            }
+    }
+}
+
+TEST_F(SocialNetworkTest, CycleSearchSurvivesLongChains) {
+    // Deep enough to overflow a recursive search.
+    const int length = 300000;
+    vector<pair<int, int>> chain;
+    for (int i = 1; i < length; ++i) chain.push_back({ i, i + 1 });
+    network.buildGraph(chain, Layer::Friendship);
+    EXPECT_FALSE(network.hasCycle(Layer::Friendship));
+    EXPECT_FALSE(GraphAlgorithms::hasCycle(network.currentSnapshot(Layer::Friendship)));
+
+    network.addAdjacency(length, 1, Layer::Friendship);
+    EXPECT_TRUE(network.hasCycle(Layer::Friendship));
+    EXPECT_TRUE(GraphAlgorithms::hasCycle(network.currentSnapshot(Layer::Friendship)));
+}
+
+TEST_F(SocialNetworkTest, MutualFollowClustersAreStrongComponents) {
+    for (int id = 4; id <= 6; ++id) {
+        auto* u = new RegularUser(id, "User" + to_string(id), "user" + to_string(id) + "@mail.com");
+        createdUsers.push_back(u);
+        network.addUser(u);
+    }
+    // Loop 1 -> 2 -> 3 -> 1, mutual pair 4 <-> 5, and one-way links between them.
+    ASSERT_NO_FATAL_FAILURE({
+        for (auto f : vector<pair<int, int>>{ { 1, 2 }, { 2, 3 }, { 3, 1 }, { 3, 4 }, { 4, 5 }, { 5, 4 }, { 6, 1 } })
+            network.addSubscription(f.first, f.second);
+        network.addFriendship(6, 5);
+        });
+
+    auto clusters = network.mutualFollowClusters();
+    ASSERT_EQ(clusters.size(), 2);
+    EXPECT_EQ(clusters[0], vector<int>({ 1, 2, 3 }));
+    EXPECT_EQ(clusters[1], vector<int>({ 4, 5 }));
+
+    network.addSubscription(5, 6);
+    clusters = network.mutualFollowClusters();
+    ASSERT_EQ(clusters.size(), 1) << "6 -> 1 -> 3 -> 4 -> 5 -> 6 merges everything";
+    EXPECT_EQ(clusters[0].size(), 6);
+}
+
+TEST_F(SocialNetworkTest, FollowerGraphSharesSnapshotSlots) {
+    network.emplaceVertex<RegularUser>(4, "Dora", "dora@mail.com");
+    ASSERT_NO_FATAL_FAILURE({
+        network.addSubscription(4, 1);
+        network.addSubscription(2, 3);
+        network.removeUser(4);
+        network.emplaceVertex<RegularUser>(5, "Emil", "emil@mail.com");
+        network.addSubscription(5, 1);
+        network.addSubscription(3, 5);
+        });
+
+    // Both snapshots number the users the same way, reused slot included.
+    const auto& followers = network.followerGraph();
+    const auto& layer = network.currentSnapshot(Layer::Subscription);
+    EXPECT_EQ(followers.vertexIds(), layer.vertexIds());
+    EXPECT_EQ(followers.vertexIds(), vector<int>({ 1, 2, 3, 5 }));
+    auto followersOf = [&followers](int id) {
+        vector<int> result;
+        for (int v : followers.neighbors(followers.indexOf(id))) result.push_back(followers.idOf(v));
+        return result;
+    };
+    EXPECT_EQ(followersOf(1), vector<int>({ 5 }));
+    EXPECT_EQ(followersOf(5), vector<int>({ 3 }));
+    EXPECT_EQ(followersOf(3), vector<int>({ 2 }));
+}
+
+TEST_F(SocialNetworkTest, RelationshipCachesFollowTheirOwnLayers) {
+    ASSERT_NO_FATAL_FAILURE({
+        network.addSubscription(1, 2);
+        network.sendMessage(1, 3, "Hi");
+        });
+    EXPECT_EQ(network.followerGraph().edgeCount(), 1);
+    double influence = network.influenceOf(2);
+    auto subscriptions = network.getRevision(Layer::Subscription);
+
+    // Friendships and messages leave the subscription caches alone.
+    network.addFriendship(2, 3);
+    network.sendMessage(3, 1, "Hello");
+    EXPECT_EQ(network.getRevision(Layer::Subscription), subscriptions);
+    EXPECT_EQ(network.influenceOf(2), influence);
+
+    // A reverse follow does not change the undirected layer, but does
+    // change who follows whom.
+    network.addSubscription(2, 1);
+    EXPECT_EQ(network.followerGraph().edgeCount(), 2);
+
+    // A second message only strengthens an existing tie.
+    auto weightOf = [this](int a, int b) {
+        const auto& g = network.tieGraph();
+        int v = g.indexOf(a), u = g.indexOf(b);
+        size_t e = g.edgeBegin(v);
+        for (int w : g.neighbors(v)) {
+            if (w == u) return g.weight(e);
+            ++e;
+        }
+        return -1.0;
+    };
+    double before = weightOf(1, 3);
+    network.sendMessage(1, 3, "Again");
+    EXPECT_LT(weightOf(1, 3), before);
+}
+
+TEST(StrongComponentsTest, MatchesReachability) {
+    mt19937 rng(17);
+    uniform_int_distribution<int> pick(0, 59);
+    vector<pair<int, int>> arcs;
+    for (int i = 0; i < 90; ++i) arcs.push_back({ pick(rng), pick(rng) });
+    CsrGraph g = CsrGraph::fromEdges(arcs, false);
+    int n = g.vertexCount();
+
+    // Transitive closure by repeated BFS.
+    vector<vector<char>> reach(n, vector<char>(n, 0));
+    for (int s = 0; s < n; ++s) {
+        vector<int> queue = { s };
+        reach[s][s] = 1;
+        for (size_t head = 0; head < queue.size(); ++head)
+            for (int u : g.neighbors(queue[head]))
+                if (!reach[s][u]) {
+                    reach[s][u] = 1;
+                    queue.push_back(u);
+                }
+    }
+
+    int count = 0;
+    auto component = GraphAlgorithms::stronglyConnectedComponents(g, &count);
+    set<int> labels(component.begin(), component.end());
+    EXPECT_EQ(static_cast<int>(labels.size()), count);
+    for (int a = 0; a < n; ++a)
+        for (int b = 0; b < n; ++b) {
+            EXPECT_EQ(component[a] == component[b], reach[a][b] && reach[b][a]) << a << " " << b;
+            // Reverse topological numbering: arcs never point to a later component.
+            if (reach[a][b]) {
+                EXPECT_GE(component[a], component[b]);
+            }
+        }
+
+    // One long directed loop is a single component, found without recursion.
+    vector<pair<int, int>> loop;
+    for (int i = 0; i < 300000; ++i) loop.push_back({ i, (i + 1) % 300000 });
+    CsrGraph ring = CsrGraph::fromEdges(loop, false);
+    GraphAlgorithms::stronglyConnectedComponents(ring, &count);
+    EXPECT_EQ(count, 1);
+}
+
+TEST(NeighborhoodFunctionTest, TracksExactBalls) {
+    mt19937 rng(23);
+    uniform_int_distribution<int> pick(0, 499);
+    vector<pair<int, int>> edges;
+    for (int i = 0; i < 700; ++i) edges.push_back({ pick(rng), pick(rng) });
+    CsrGraph g = CsrGraph::fromEdges(edges);
+    int n = g.vertexCount();
+
+    // Exact ball sizes by BFS from every vertex.
+    vector<vector<int>> ball(n);
+    for (int s = 0; s < n; ++s) {
+        vector<int> distance(n, -1), queue = { s };
+        distance[s] = 0;
+        for (size_t head = 0; head < queue.size(); ++head)
+            for (int u : g.neighbors(queue[head]))
+                if (distance[u] < 0) {
+                    distance[u] = distance[queue[head]] + 1;
+                    queue.push_back(u);
+                }
+        for (int d : distance)
+            if (d >= 0) {
+                if (static_cast<int>(ball[s].size()) <= d) ball[s].resize(d + 1, 0);
+                ++ball[s][d];
+            }
+        for (size_t d = 1; d < ball[s].size(); ++d) ball[s][d] += ball[s][d - 1];
+    }
+    auto exactWithin = [&ball](int s, size_t t) { return ball[s][min(t, ball[s].size() - 1)]; };
+
+    auto anf = NeighborhoodFunction::compute(g, 3, 8, 2);
+    const auto& pairs = anf.neighborhood();
+    size_t depth = 0;
+    for (const auto& b : ball) depth = max(depth, b.size() - 1);
+    // A pass that adds only a few far vertices may leave every counter
+    // as is, so the estimate can stop a hop or two early.
+    ASSERT_LE(pairs.size(), depth + 1);
+    EXPECT_GE(pairs.size() + 2, depth + 1);
+    vector<double> exact(depth + 1, 0.0);
+    for (size_t t = 0; t <= depth; ++t) {
+        for (int s = 0; s < n; ++s) exact[t] += exactWithin(s, t);
+        // Once balls merge into the giant component their counters are
+        // the same, so the sum is no better than one counter.
+        if (t < pairs.size()) {
+            EXPECT_NEAR(pairs[t], exact[t], 3 * anf.relativeError() * exact[t]) << "t = " << t;
+        }
+    }
+
+    double error = 0;
+    for (int s = 0; s < n; ++s)
+        error += fabs(anf.reach(g.idOf(s)) - exactWithin(s, 3)) / exactWithin(s, 3);
+    EXPECT_LT(error / n, 2 * anf.relativeError());
+    EXPECT_EQ(anf.reach(-1), 0.0);
+
+    // The estimate's diameter sits close to the one of the exact function.
+    double target = 0.9 * exact.back();
+    size_t t = 0;
+    while (exact[t] < target) ++t;
+    double diameter = t ? (t - 1) + (target - exact[t - 1]) / (exact[t] - exact[t - 1]) : 0.0;
+    EXPECT_NEAR(anf.effectiveDiameter(), diameter, 0.3);
+    EXPECT_GT(anf.averageDistance(), 1.0);
+}
+
+TEST_F(SocialNetworkTest, AlgorithmAdjacencyFollowsMutations) {
+    ASSERT_NO_FATAL_FAILURE({
+        network.addFriendship(1, 2);
+        network.addFriendship(2, 3);
+        });
+    EXPECT_EQ(network.distanceBetween(1, 3), 2);
+
+    auto epochBefore = network.getEpoch();
+    const CsrGraph* first = &network.currentSnapshot();
+    EXPECT_EQ(&network.currentSnapshot(), first);
+    network.userCentrality();
+    EXPECT_EQ(network.getEpoch(), epochBefore) << "Queries must not rebuild the adjacency";
+
+    network.removeFriendship(2, 3);
+    EXPECT_NE(network.getEpoch(), epochBefore);
+    EXPECT_EQ(network.distanceBetween(1, 3), -1) << "Distance must not use a stale adjacency";
+    EXPECT_FALSE(network.areConnected(1, 3));
+
+    auto centrality = network.userCentrality();
+    EXPECT_EQ(centrality[2], 1);
+    EXPECT_EQ(centrality.count(3), 0);
+}
+
+TEST_F(SocialNetworkTest, AlgorithmsRunOnRelationshipLayers) {
+    ASSERT_NO_FATAL_FAILURE({
+        network.addFriendship(1, 2);
+        network.addSubscription(2, 3);
+        network.sendMessage(1, 3, "Hi");
+        network.sendMessage(1, 3, "Hi again");
+        network.addPost(1, "Hello");
+        });
+
+    EXPECT_EQ(network.distanceBetween(1, 3), -1) << "Subscriptions are not friendships";
+    EXPECT_EQ(network.distanceBetween(1, 3, Layer::Message), 1);
+    EXPECT_EQ(network.distanceBetween(1, 3, Layer::All), 1);
+    EXPECT_TRUE(network.areConnected(2, 3, Layer::Subscription));
+
+    auto all = network.userCentrality();
+    EXPECT_EQ(all.count(-1), 0) << "Posts must not add a phantom vertex";
+    EXPECT_EQ(all[1], 2);
+
+    auto messages = network.userCentrality(Layer::Message);
+    EXPECT_EQ(messages[1], 1) << "Repeated messages must not duplicate neighbors";
+    EXPECT_EQ(messages.count(2), 0);
+}
+
+TEST(GenerateRandomUsersTest, SecondBatchAddsNewUsers) {
+    SocialNetwork network;
+    SocialNetwork::generateRandomUsers(network, 50);
+    ASSERT_NO_FATAL_FAILURE(SocialNetwork::generateRandomUsers(network, 50));
+    EXPECT_EQ(network.vertexCount(), 100);
+    EXPECT_NE(network.getUser(99), nullptr);
+}
+
+TEST_F(SocialNetworkTest, RemoveFriendshipKeepsOtherRelationships) {
+    ASSERT_NO_FATAL_FAILURE({
+        network.addFriendship(1, 2);
+        network.sendMessage(1, 2, "Hi");
+        network.removeFriendship(2, 1);
+        });
+
+    EXPECT_FALSE(network.hasEdge(1, 2, EdgeKind::Friendship));
+    EXPECT_EQ(network.getMessagesOfUser(1).size(), 1);
+    EXPECT_EQ(network.distanceBetween(1, 2), -1);
+    EXPECT_EQ(network.distanceBetween(1, 2, Layer::All), 1) << "The message still links the users";
+}
+
+// A relationship of no particular kind; it lives only in the All layer.
+class GenericEdge : public Edge {
+public:
+    GenericEdge(int f, int t) : Edge(f, t) {}
+    void print() const override {}
+};
+
+TEST_F(SocialNetworkTest, RemoveGenericEdgeKeepsFriendship) {
+    ASSERT_NO_FATAL_FAILURE({
+        network.addFriendship(1, 2);
+        network.addEdge(new GenericEdge(1, 2));
+        network.removeEdge(1, 2, EdgeKind::Generic);
+        });
+
+    EXPECT_EQ(network.countType<Friendship>(), 2);
+    EXPECT_TRUE(network.areConnected(1, 2));
+    EXPECT_EQ(network.currentSnapshot(Layer::Friendship).edgeCount(), 2);
+    EXPECT_EQ(network.distanceBetween(1, 2, Layer::All), 1) << "The friendship still links the users";
+
+    network.addEdge(new GenericEdge(2, 3));
+    network.addEdge(new GenericEdge(3, 2));
+    network.removeEdge(2, 3, EdgeKind::Generic);
+    EXPECT_EQ(network.distanceBetween(2, 3, Layer::All), -1);
+}